@@ -0,0 +1,7 @@
+#include "perform.h"
+
+int main()
+{
+    cwake_lib_performance();
+    return 0;
+}
@@ -11,6 +11,12 @@
 
 #include "cwake.h"
 
+// x86 SIMD kernels (selected at runtime in cwake_init, CWAKE_NO_SIMD disables)
+#if !defined(CWAKE_NO_SIMD) && defined(__GNUC__) && defined(__SSE2__)
+#define CWAKE_SIMD_X86
+#include <immintrin.h>
+#endif
+
 #ifndef CWAKE_TEST
 #define DSTATIC static
 #else
@@ -21,23 +27,34 @@
 #include <ctype.h>
 extern void cwake_debug_print(const char *format, ...);
 #define DEBUG_PRINT(msg, ...) cwake_debug_print(msg, ##__VA_ARGS__)
-static char* format_hex_ascii(const unsigned char *data, size_t size) {
-    static char out_str[2042];
-    const size_t out_max = sizeof(out_str);
+// dump is formatted on caller stack, so instances may log from any thread
+#define DEBUG_PRINT_HEX(msg, data, size) do { \
+        char hex_str[2042]; \
+        cwake_debug_print(msg, format_hex_ascii(hex_str, sizeof(hex_str), data, size)); \
+    } while (0)
+static char* format_hex_ascii(char* out_str, size_t out_max,
+                              const unsigned char *data, size_t size) {
+    static const char digits[] = "0123456789ABCDEF";
+    // 4 chars per byte, long dumps are truncated
+    if (size > (out_max - 3) / 4) size = (out_max - 3) / 4;
 
-    size_t pos = 0;
-    for (size_t i = 0; i < size; i++)
-        pos += snprintf(out_str + pos, out_max - pos, "%02X ", data[i]);
-    pos += snprintf(out_str + pos, out_max - pos, "| ");
+    char* out = out_str;
+    for (size_t i = 0; i < size; i++) {
+        *out++ = digits[data[i] >> 4];
+        *out++ = digits[data[i] & 0x0F];
+        *out++ = ' ';
+    }
+    *out++ = '|';
+    *out++ = ' ';
     for (size_t i = 0; i < size; i++) {
-        char c = isprint(data[i]) ? data[i] : '.';
-        pos += snprintf(out_str + pos, out_max - pos, "%c", c);
+        *out++ = isprint(data[i]) ? data[i] : '.';
     }
-    out_str[pos] = 0;
+    *out = 0;
     return out_str;
 }
 #else
 #define DEBUG_PRINT(msg, ...)
+#define DEBUG_PRINT_HEX(msg, data, size)
 #endif
 
 // =============================================================== Declarations
@@ -48,50 +65,70 @@ DSTATIC const uint8_t TFEND = 0xDC;
 DSTATIC const uint8_t TFESC = 0xDD;
 DSTATIC const uint8_t PREAMBLE = FEND;
 
-DSTATIC const uint8_t CRC8_POLYNOMIAL = 0x31;
+#ifdef CWAKE_TEST
+DSTATIC const uint8_t CRC8_POLYNOMIAL = 0x31; // of precomputed tables, for tests
+#endif
+
+// extended frames: flag byte in place of N selects CRC
+DSTATIC const uint8_t EXT_FLAG_CRC16 = 0xFE;
+DSTATIC const uint8_t EXT_FLAG_CRC32 = 0xFF;
 
 // sizes
-DSTATIC const size_t WORK_BUFFER_SIZE    = 256;
-DSTATIC const size_t STUFFER_BUFFER_SIZE = WORK_BUFFER_SIZE*2;
-
 DSTATIC const size_t PREAMBLE_SIZE   = 1;
 DSTATIC const size_t HEADER_SIZE     = 3;
 DSTATIC const size_t CRC_SIZE        = 1;
+DSTATIC const size_t CLASSIC_DATA_MAX = 251;
+
+DSTATIC const size_t EXT_HEADER_SIZE = 5;   // ADDR, CMD, flag, length (LE)
 
 // positions
-DSTATIC const int16_t PREAMBLE_POS    = -1; // !!! PREAMBLE is not saved in buffer
 DSTATIC const int16_t ADDR_POS        = 0;
 DSTATIC const int16_t CMD_POS         = 1;
 DSTATIC const int16_t SIZE_POS        = 2;
-DSTATIC const int16_t DATA_POS        = 3;
+#ifdef CWAKE_TEST
+DSTATIC const int16_t PREAMBLE_POS    = -1; // !!! PREAMBLE is not saved in buffer
+DSTATIC const int16_t DATA_POS        = 3;  // classic frames, data is located by header
+#endif
+
+// scatter-gather transmit
+#define GATHER_SEGMENTS_MAX 16
+DSTATIC const size_t GATHER_PART_MIN_SIZE = 16; // shorter parts are copied
+
+// kernels
+DSTATIC const int KERNEL_SCALAR = 0;
+#if defined(CWAKE_SIMD_X86) || defined(CWAKE_TEST)
+DSTATIC const int KERNEL_SSE2   = 1;
+DSTATIC const int KERNEL_AVX2   = 2;
+#endif
+#ifdef CWAKE_TEST
+static int kernel_limit = INT32_MAX; // set by select_kernels()
+#endif
 
 // Global structures and variebles
-DSTATIC uint8_t crc8_table       [256];
+static const uint8_t crc8_table  [8][256]; // slicing-by-8 tables (read-only)
+static const uint16_t crc16_table[8][256];
+static const uint32_t crc32_table[8][256];
 
 
 // ========================================================= Service functional
-static inline void reset_buffer_rxenc(cwake_platform* platform)
+static inline void reset_buffer_rx(cwake_platform* platform)
 {
-    platform->service.buffer_rxenc_dend = platform->service.buffer_rxenc;
-    platform->service.buffer_rxenc_dstart = platform->service.buffer_rxenc;
+    platform->service.rx_head = 0;
+    platform->service.rx_tail = 0;
+    platform->service.rx_parsed = 0;
+    platform->service.preamble_is_received = 0;
 }
+// next frame is decoded in place of encoded data not parsed yet
 static inline  void reset_buffer_rxdec(cwake_platform* platform)
 {
-    platform->service.buffer_rxdec_dend = platform->service.buffer_rxdec;
-}
-static inline  int is_empty_buffer_rxenc(cwake_platform* platform)
-{
-    if(platform->service.buffer_rxenc_dstart >=
-        platform->service.buffer_rxenc_dend) {
-        reset_buffer_rxenc(platform);
-        return 1;
-    }
-    return 0;
+    platform->service.rx_frame = platform->service.rx_tail;
+    platform->service.rx_dend = platform->service.rx_tail;
+    platform->service.rx_crc = crc8_table[0][PREAMBLE]; // crc of preamble
 }
 
 static inline  void start_timeout_timer(cwake_platform* platform)
 {
-    platform->service.start_pending_time = platform->current_time_ms();
+    platform->service.start_pending_time = platform->current_time_ms(platform->user);
 }
 
 static inline  void stop_timeout_timer(cwake_platform* platform)
@@ -105,7 +142,7 @@ DSTATIC uint8_t is_timeout(cwake_platform* platform)
 
     if ( start == 0) return 0; //timer is not started
 
-    uint32_t current = platform->current_time_ms();
+    uint32_t current = platform->current_time_ms(platform->user);
     uint32_t passed = 0;
 
     //overflow checking
@@ -118,36 +155,793 @@ DSTATIC uint8_t is_timeout(cwake_platform* platform)
 }
 
 // CRC-8
-DSTATIC void generate_crc8_table(uint8_t polynomial)
-{
-    for (int i = 0; i < 256; i++) {
-        uint8_t crc = i;
-        for (int j = 0; j < 8; j++) {
-            if (crc & 0x80) {
-                crc = (crc << 1) ^ polynomial;
-            } else {
-                crc <<= 1;
-            }
-        }
-        crc8_table[i] = crc;
+// crc8_table[0] is the classic bytewise table, crc8_table[k][x] is crc of
+// byte x followed by k zero bytes. CRC is linear, so 8 bytes are folded
+// with 8 independent lookups instead of a chain of 8 dependent ones.
+// Tables are precomputed for CRC8_POLYNOMIAL and placed in read-only memory.
+static const uint8_t crc8_table[8][256] = {
+    {
+        0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+        0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+        0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+        0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+        0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+        0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+        0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+        0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+        0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+        0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+        0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+        0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+        0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+        0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+        0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+        0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC,
+    },
+    {
+        0x00, 0xF4, 0xD9, 0x2D, 0x83, 0x77, 0x5A, 0xAE, 0x37, 0xC3, 0xEE, 0x1A, 0xB4, 0x40, 0x6D, 0x99,
+        0x6E, 0x9A, 0xB7, 0x43, 0xED, 0x19, 0x34, 0xC0, 0x59, 0xAD, 0x80, 0x74, 0xDA, 0x2E, 0x03, 0xF7,
+        0xDC, 0x28, 0x05, 0xF1, 0x5F, 0xAB, 0x86, 0x72, 0xEB, 0x1F, 0x32, 0xC6, 0x68, 0x9C, 0xB1, 0x45,
+        0xB2, 0x46, 0x6B, 0x9F, 0x31, 0xC5, 0xE8, 0x1C, 0x85, 0x71, 0x5C, 0xA8, 0x06, 0xF2, 0xDF, 0x2B,
+        0x89, 0x7D, 0x50, 0xA4, 0x0A, 0xFE, 0xD3, 0x27, 0xBE, 0x4A, 0x67, 0x93, 0x3D, 0xC9, 0xE4, 0x10,
+        0xE7, 0x13, 0x3E, 0xCA, 0x64, 0x90, 0xBD, 0x49, 0xD0, 0x24, 0x09, 0xFD, 0x53, 0xA7, 0x8A, 0x7E,
+        0x55, 0xA1, 0x8C, 0x78, 0xD6, 0x22, 0x0F, 0xFB, 0x62, 0x96, 0xBB, 0x4F, 0xE1, 0x15, 0x38, 0xCC,
+        0x3B, 0xCF, 0xE2, 0x16, 0xB8, 0x4C, 0x61, 0x95, 0x0C, 0xF8, 0xD5, 0x21, 0x8F, 0x7B, 0x56, 0xA2,
+        0x23, 0xD7, 0xFA, 0x0E, 0xA0, 0x54, 0x79, 0x8D, 0x14, 0xE0, 0xCD, 0x39, 0x97, 0x63, 0x4E, 0xBA,
+        0x4D, 0xB9, 0x94, 0x60, 0xCE, 0x3A, 0x17, 0xE3, 0x7A, 0x8E, 0xA3, 0x57, 0xF9, 0x0D, 0x20, 0xD4,
+        0xFF, 0x0B, 0x26, 0xD2, 0x7C, 0x88, 0xA5, 0x51, 0xC8, 0x3C, 0x11, 0xE5, 0x4B, 0xBF, 0x92, 0x66,
+        0x91, 0x65, 0x48, 0xBC, 0x12, 0xE6, 0xCB, 0x3F, 0xA6, 0x52, 0x7F, 0x8B, 0x25, 0xD1, 0xFC, 0x08,
+        0xAA, 0x5E, 0x73, 0x87, 0x29, 0xDD, 0xF0, 0x04, 0x9D, 0x69, 0x44, 0xB0, 0x1E, 0xEA, 0xC7, 0x33,
+        0xC4, 0x30, 0x1D, 0xE9, 0x47, 0xB3, 0x9E, 0x6A, 0xF3, 0x07, 0x2A, 0xDE, 0x70, 0x84, 0xA9, 0x5D,
+        0x76, 0x82, 0xAF, 0x5B, 0xF5, 0x01, 0x2C, 0xD8, 0x41, 0xB5, 0x98, 0x6C, 0xC2, 0x36, 0x1B, 0xEF,
+        0x18, 0xEC, 0xC1, 0x35, 0x9B, 0x6F, 0x42, 0xB6, 0x2F, 0xDB, 0xF6, 0x02, 0xAC, 0x58, 0x75, 0x81,
+    },
+    {
+        0x00, 0x46, 0x8C, 0xCA, 0x29, 0x6F, 0xA5, 0xE3, 0x52, 0x14, 0xDE, 0x98, 0x7B, 0x3D, 0xF7, 0xB1,
+        0xA4, 0xE2, 0x28, 0x6E, 0x8D, 0xCB, 0x01, 0x47, 0xF6, 0xB0, 0x7A, 0x3C, 0xDF, 0x99, 0x53, 0x15,
+        0x79, 0x3F, 0xF5, 0xB3, 0x50, 0x16, 0xDC, 0x9A, 0x2B, 0x6D, 0xA7, 0xE1, 0x02, 0x44, 0x8E, 0xC8,
+        0xDD, 0x9B, 0x51, 0x17, 0xF4, 0xB2, 0x78, 0x3E, 0x8F, 0xC9, 0x03, 0x45, 0xA6, 0xE0, 0x2A, 0x6C,
+        0xF2, 0xB4, 0x7E, 0x38, 0xDB, 0x9D, 0x57, 0x11, 0xA0, 0xE6, 0x2C, 0x6A, 0x89, 0xCF, 0x05, 0x43,
+        0x56, 0x10, 0xDA, 0x9C, 0x7F, 0x39, 0xF3, 0xB5, 0x04, 0x42, 0x88, 0xCE, 0x2D, 0x6B, 0xA1, 0xE7,
+        0x8B, 0xCD, 0x07, 0x41, 0xA2, 0xE4, 0x2E, 0x68, 0xD9, 0x9F, 0x55, 0x13, 0xF0, 0xB6, 0x7C, 0x3A,
+        0x2F, 0x69, 0xA3, 0xE5, 0x06, 0x40, 0x8A, 0xCC, 0x7D, 0x3B, 0xF1, 0xB7, 0x54, 0x12, 0xD8, 0x9E,
+        0xD5, 0x93, 0x59, 0x1F, 0xFC, 0xBA, 0x70, 0x36, 0x87, 0xC1, 0x0B, 0x4D, 0xAE, 0xE8, 0x22, 0x64,
+        0x71, 0x37, 0xFD, 0xBB, 0x58, 0x1E, 0xD4, 0x92, 0x23, 0x65, 0xAF, 0xE9, 0x0A, 0x4C, 0x86, 0xC0,
+        0xAC, 0xEA, 0x20, 0x66, 0x85, 0xC3, 0x09, 0x4F, 0xFE, 0xB8, 0x72, 0x34, 0xD7, 0x91, 0x5B, 0x1D,
+        0x08, 0x4E, 0x84, 0xC2, 0x21, 0x67, 0xAD, 0xEB, 0x5A, 0x1C, 0xD6, 0x90, 0x73, 0x35, 0xFF, 0xB9,
+        0x27, 0x61, 0xAB, 0xED, 0x0E, 0x48, 0x82, 0xC4, 0x75, 0x33, 0xF9, 0xBF, 0x5C, 0x1A, 0xD0, 0x96,
+        0x83, 0xC5, 0x0F, 0x49, 0xAA, 0xEC, 0x26, 0x60, 0xD1, 0x97, 0x5D, 0x1B, 0xF8, 0xBE, 0x74, 0x32,
+        0x5E, 0x18, 0xD2, 0x94, 0x77, 0x31, 0xFB, 0xBD, 0x0C, 0x4A, 0x80, 0xC6, 0x25, 0x63, 0xA9, 0xEF,
+        0xFA, 0xBC, 0x76, 0x30, 0xD3, 0x95, 0x5F, 0x19, 0xA8, 0xEE, 0x24, 0x62, 0x81, 0xC7, 0x0D, 0x4B,
+    },
+    {
+        0x00, 0x9B, 0x07, 0x9C, 0x0E, 0x95, 0x09, 0x92, 0x1C, 0x87, 0x1B, 0x80, 0x12, 0x89, 0x15, 0x8E,
+        0x38, 0xA3, 0x3F, 0xA4, 0x36, 0xAD, 0x31, 0xAA, 0x24, 0xBF, 0x23, 0xB8, 0x2A, 0xB1, 0x2D, 0xB6,
+        0x70, 0xEB, 0x77, 0xEC, 0x7E, 0xE5, 0x79, 0xE2, 0x6C, 0xF7, 0x6B, 0xF0, 0x62, 0xF9, 0x65, 0xFE,
+        0x48, 0xD3, 0x4F, 0xD4, 0x46, 0xDD, 0x41, 0xDA, 0x54, 0xCF, 0x53, 0xC8, 0x5A, 0xC1, 0x5D, 0xC6,
+        0xE0, 0x7B, 0xE7, 0x7C, 0xEE, 0x75, 0xE9, 0x72, 0xFC, 0x67, 0xFB, 0x60, 0xF2, 0x69, 0xF5, 0x6E,
+        0xD8, 0x43, 0xDF, 0x44, 0xD6, 0x4D, 0xD1, 0x4A, 0xC4, 0x5F, 0xC3, 0x58, 0xCA, 0x51, 0xCD, 0x56,
+        0x90, 0x0B, 0x97, 0x0C, 0x9E, 0x05, 0x99, 0x02, 0x8C, 0x17, 0x8B, 0x10, 0x82, 0x19, 0x85, 0x1E,
+        0xA8, 0x33, 0xAF, 0x34, 0xA6, 0x3D, 0xA1, 0x3A, 0xB4, 0x2F, 0xB3, 0x28, 0xBA, 0x21, 0xBD, 0x26,
+        0xF1, 0x6A, 0xF6, 0x6D, 0xFF, 0x64, 0xF8, 0x63, 0xED, 0x76, 0xEA, 0x71, 0xE3, 0x78, 0xE4, 0x7F,
+        0xC9, 0x52, 0xCE, 0x55, 0xC7, 0x5C, 0xC0, 0x5B, 0xD5, 0x4E, 0xD2, 0x49, 0xDB, 0x40, 0xDC, 0x47,
+        0x81, 0x1A, 0x86, 0x1D, 0x8F, 0x14, 0x88, 0x13, 0x9D, 0x06, 0x9A, 0x01, 0x93, 0x08, 0x94, 0x0F,
+        0xB9, 0x22, 0xBE, 0x25, 0xB7, 0x2C, 0xB0, 0x2B, 0xA5, 0x3E, 0xA2, 0x39, 0xAB, 0x30, 0xAC, 0x37,
+        0x11, 0x8A, 0x16, 0x8D, 0x1F, 0x84, 0x18, 0x83, 0x0D, 0x96, 0x0A, 0x91, 0x03, 0x98, 0x04, 0x9F,
+        0x29, 0xB2, 0x2E, 0xB5, 0x27, 0xBC, 0x20, 0xBB, 0x35, 0xAE, 0x32, 0xA9, 0x3B, 0xA0, 0x3C, 0xA7,
+        0x61, 0xFA, 0x66, 0xFD, 0x6F, 0xF4, 0x68, 0xF3, 0x7D, 0xE6, 0x7A, 0xE1, 0x73, 0xE8, 0x74, 0xEF,
+        0x59, 0xC2, 0x5E, 0xC5, 0x57, 0xCC, 0x50, 0xCB, 0x45, 0xDE, 0x42, 0xD9, 0x4B, 0xD0, 0x4C, 0xD7,
+    },
+    {
+        0x00, 0xD3, 0x97, 0x44, 0x1F, 0xCC, 0x88, 0x5B, 0x3E, 0xED, 0xA9, 0x7A, 0x21, 0xF2, 0xB6, 0x65,
+        0x7C, 0xAF, 0xEB, 0x38, 0x63, 0xB0, 0xF4, 0x27, 0x42, 0x91, 0xD5, 0x06, 0x5D, 0x8E, 0xCA, 0x19,
+        0xF8, 0x2B, 0x6F, 0xBC, 0xE7, 0x34, 0x70, 0xA3, 0xC6, 0x15, 0x51, 0x82, 0xD9, 0x0A, 0x4E, 0x9D,
+        0x84, 0x57, 0x13, 0xC0, 0x9B, 0x48, 0x0C, 0xDF, 0xBA, 0x69, 0x2D, 0xFE, 0xA5, 0x76, 0x32, 0xE1,
+        0xC1, 0x12, 0x56, 0x85, 0xDE, 0x0D, 0x49, 0x9A, 0xFF, 0x2C, 0x68, 0xBB, 0xE0, 0x33, 0x77, 0xA4,
+        0xBD, 0x6E, 0x2A, 0xF9, 0xA2, 0x71, 0x35, 0xE6, 0x83, 0x50, 0x14, 0xC7, 0x9C, 0x4F, 0x0B, 0xD8,
+        0x39, 0xEA, 0xAE, 0x7D, 0x26, 0xF5, 0xB1, 0x62, 0x07, 0xD4, 0x90, 0x43, 0x18, 0xCB, 0x8F, 0x5C,
+        0x45, 0x96, 0xD2, 0x01, 0x5A, 0x89, 0xCD, 0x1E, 0x7B, 0xA8, 0xEC, 0x3F, 0x64, 0xB7, 0xF3, 0x20,
+        0xB3, 0x60, 0x24, 0xF7, 0xAC, 0x7F, 0x3B, 0xE8, 0x8D, 0x5E, 0x1A, 0xC9, 0x92, 0x41, 0x05, 0xD6,
+        0xCF, 0x1C, 0x58, 0x8B, 0xD0, 0x03, 0x47, 0x94, 0xF1, 0x22, 0x66, 0xB5, 0xEE, 0x3D, 0x79, 0xAA,
+        0x4B, 0x98, 0xDC, 0x0F, 0x54, 0x87, 0xC3, 0x10, 0x75, 0xA6, 0xE2, 0x31, 0x6A, 0xB9, 0xFD, 0x2E,
+        0x37, 0xE4, 0xA0, 0x73, 0x28, 0xFB, 0xBF, 0x6C, 0x09, 0xDA, 0x9E, 0x4D, 0x16, 0xC5, 0x81, 0x52,
+        0x72, 0xA1, 0xE5, 0x36, 0x6D, 0xBE, 0xFA, 0x29, 0x4C, 0x9F, 0xDB, 0x08, 0x53, 0x80, 0xC4, 0x17,
+        0x0E, 0xDD, 0x99, 0x4A, 0x11, 0xC2, 0x86, 0x55, 0x30, 0xE3, 0xA7, 0x74, 0x2F, 0xFC, 0xB8, 0x6B,
+        0x8A, 0x59, 0x1D, 0xCE, 0x95, 0x46, 0x02, 0xD1, 0xB4, 0x67, 0x23, 0xF0, 0xAB, 0x78, 0x3C, 0xEF,
+        0xF6, 0x25, 0x61, 0xB2, 0xE9, 0x3A, 0x7E, 0xAD, 0xC8, 0x1B, 0x5F, 0x8C, 0xD7, 0x04, 0x40, 0x93,
+    },
+    {
+        0x00, 0x57, 0xAE, 0xF9, 0x6D, 0x3A, 0xC3, 0x94, 0xDA, 0x8D, 0x74, 0x23, 0xB7, 0xE0, 0x19, 0x4E,
+        0x85, 0xD2, 0x2B, 0x7C, 0xE8, 0xBF, 0x46, 0x11, 0x5F, 0x08, 0xF1, 0xA6, 0x32, 0x65, 0x9C, 0xCB,
+        0x3B, 0x6C, 0x95, 0xC2, 0x56, 0x01, 0xF8, 0xAF, 0xE1, 0xB6, 0x4F, 0x18, 0x8C, 0xDB, 0x22, 0x75,
+        0xBE, 0xE9, 0x10, 0x47, 0xD3, 0x84, 0x7D, 0x2A, 0x64, 0x33, 0xCA, 0x9D, 0x09, 0x5E, 0xA7, 0xF0,
+        0x76, 0x21, 0xD8, 0x8F, 0x1B, 0x4C, 0xB5, 0xE2, 0xAC, 0xFB, 0x02, 0x55, 0xC1, 0x96, 0x6F, 0x38,
+        0xF3, 0xA4, 0x5D, 0x0A, 0x9E, 0xC9, 0x30, 0x67, 0x29, 0x7E, 0x87, 0xD0, 0x44, 0x13, 0xEA, 0xBD,
+        0x4D, 0x1A, 0xE3, 0xB4, 0x20, 0x77, 0x8E, 0xD9, 0x97, 0xC0, 0x39, 0x6E, 0xFA, 0xAD, 0x54, 0x03,
+        0xC8, 0x9F, 0x66, 0x31, 0xA5, 0xF2, 0x0B, 0x5C, 0x12, 0x45, 0xBC, 0xEB, 0x7F, 0x28, 0xD1, 0x86,
+        0xEC, 0xBB, 0x42, 0x15, 0x81, 0xD6, 0x2F, 0x78, 0x36, 0x61, 0x98, 0xCF, 0x5B, 0x0C, 0xF5, 0xA2,
+        0x69, 0x3E, 0xC7, 0x90, 0x04, 0x53, 0xAA, 0xFD, 0xB3, 0xE4, 0x1D, 0x4A, 0xDE, 0x89, 0x70, 0x27,
+        0xD7, 0x80, 0x79, 0x2E, 0xBA, 0xED, 0x14, 0x43, 0x0D, 0x5A, 0xA3, 0xF4, 0x60, 0x37, 0xCE, 0x99,
+        0x52, 0x05, 0xFC, 0xAB, 0x3F, 0x68, 0x91, 0xC6, 0x88, 0xDF, 0x26, 0x71, 0xE5, 0xB2, 0x4B, 0x1C,
+        0x9A, 0xCD, 0x34, 0x63, 0xF7, 0xA0, 0x59, 0x0E, 0x40, 0x17, 0xEE, 0xB9, 0x2D, 0x7A, 0x83, 0xD4,
+        0x1F, 0x48, 0xB1, 0xE6, 0x72, 0x25, 0xDC, 0x8B, 0xC5, 0x92, 0x6B, 0x3C, 0xA8, 0xFF, 0x06, 0x51,
+        0xA1, 0xF6, 0x0F, 0x58, 0xCC, 0x9B, 0x62, 0x35, 0x7B, 0x2C, 0xD5, 0x82, 0x16, 0x41, 0xB8, 0xEF,
+        0x24, 0x73, 0x8A, 0xDD, 0x49, 0x1E, 0xE7, 0xB0, 0xFE, 0xA9, 0x50, 0x07, 0x93, 0xC4, 0x3D, 0x6A,
+    },
+    {
+        0x00, 0xE9, 0xE3, 0x0A, 0xF7, 0x1E, 0x14, 0xFD, 0xDF, 0x36, 0x3C, 0xD5, 0x28, 0xC1, 0xCB, 0x22,
+        0x8F, 0x66, 0x6C, 0x85, 0x78, 0x91, 0x9B, 0x72, 0x50, 0xB9, 0xB3, 0x5A, 0xA7, 0x4E, 0x44, 0xAD,
+        0x2F, 0xC6, 0xCC, 0x25, 0xD8, 0x31, 0x3B, 0xD2, 0xF0, 0x19, 0x13, 0xFA, 0x07, 0xEE, 0xE4, 0x0D,
+        0xA0, 0x49, 0x43, 0xAA, 0x57, 0xBE, 0xB4, 0x5D, 0x7F, 0x96, 0x9C, 0x75, 0x88, 0x61, 0x6B, 0x82,
+        0x5E, 0xB7, 0xBD, 0x54, 0xA9, 0x40, 0x4A, 0xA3, 0x81, 0x68, 0x62, 0x8B, 0x76, 0x9F, 0x95, 0x7C,
+        0xD1, 0x38, 0x32, 0xDB, 0x26, 0xCF, 0xC5, 0x2C, 0x0E, 0xE7, 0xED, 0x04, 0xF9, 0x10, 0x1A, 0xF3,
+        0x71, 0x98, 0x92, 0x7B, 0x86, 0x6F, 0x65, 0x8C, 0xAE, 0x47, 0x4D, 0xA4, 0x59, 0xB0, 0xBA, 0x53,
+        0xFE, 0x17, 0x1D, 0xF4, 0x09, 0xE0, 0xEA, 0x03, 0x21, 0xC8, 0xC2, 0x2B, 0xD6, 0x3F, 0x35, 0xDC,
+        0xBC, 0x55, 0x5F, 0xB6, 0x4B, 0xA2, 0xA8, 0x41, 0x63, 0x8A, 0x80, 0x69, 0x94, 0x7D, 0x77, 0x9E,
+        0x33, 0xDA, 0xD0, 0x39, 0xC4, 0x2D, 0x27, 0xCE, 0xEC, 0x05, 0x0F, 0xE6, 0x1B, 0xF2, 0xF8, 0x11,
+        0x93, 0x7A, 0x70, 0x99, 0x64, 0x8D, 0x87, 0x6E, 0x4C, 0xA5, 0xAF, 0x46, 0xBB, 0x52, 0x58, 0xB1,
+        0x1C, 0xF5, 0xFF, 0x16, 0xEB, 0x02, 0x08, 0xE1, 0xC3, 0x2A, 0x20, 0xC9, 0x34, 0xDD, 0xD7, 0x3E,
+        0xE2, 0x0B, 0x01, 0xE8, 0x15, 0xFC, 0xF6, 0x1F, 0x3D, 0xD4, 0xDE, 0x37, 0xCA, 0x23, 0x29, 0xC0,
+        0x6D, 0x84, 0x8E, 0x67, 0x9A, 0x73, 0x79, 0x90, 0xB2, 0x5B, 0x51, 0xB8, 0x45, 0xAC, 0xA6, 0x4F,
+        0xCD, 0x24, 0x2E, 0xC7, 0x3A, 0xD3, 0xD9, 0x30, 0x12, 0xFB, 0xF1, 0x18, 0xE5, 0x0C, 0x06, 0xEF,
+        0x42, 0xAB, 0xA1, 0x48, 0xB5, 0x5C, 0x56, 0xBF, 0x9D, 0x74, 0x7E, 0x97, 0x6A, 0x83, 0x89, 0x60,
+    },
+    {
+        0x00, 0x49, 0x92, 0xDB, 0x15, 0x5C, 0x87, 0xCE, 0x2A, 0x63, 0xB8, 0xF1, 0x3F, 0x76, 0xAD, 0xE4,
+        0x54, 0x1D, 0xC6, 0x8F, 0x41, 0x08, 0xD3, 0x9A, 0x7E, 0x37, 0xEC, 0xA5, 0x6B, 0x22, 0xF9, 0xB0,
+        0xA8, 0xE1, 0x3A, 0x73, 0xBD, 0xF4, 0x2F, 0x66, 0x82, 0xCB, 0x10, 0x59, 0x97, 0xDE, 0x05, 0x4C,
+        0xFC, 0xB5, 0x6E, 0x27, 0xE9, 0xA0, 0x7B, 0x32, 0xD6, 0x9F, 0x44, 0x0D, 0xC3, 0x8A, 0x51, 0x18,
+        0x61, 0x28, 0xF3, 0xBA, 0x74, 0x3D, 0xE6, 0xAF, 0x4B, 0x02, 0xD9, 0x90, 0x5E, 0x17, 0xCC, 0x85,
+        0x35, 0x7C, 0xA7, 0xEE, 0x20, 0x69, 0xB2, 0xFB, 0x1F, 0x56, 0x8D, 0xC4, 0x0A, 0x43, 0x98, 0xD1,
+        0xC9, 0x80, 0x5B, 0x12, 0xDC, 0x95, 0x4E, 0x07, 0xE3, 0xAA, 0x71, 0x38, 0xF6, 0xBF, 0x64, 0x2D,
+        0x9D, 0xD4, 0x0F, 0x46, 0x88, 0xC1, 0x1A, 0x53, 0xB7, 0xFE, 0x25, 0x6C, 0xA2, 0xEB, 0x30, 0x79,
+        0xC2, 0x8B, 0x50, 0x19, 0xD7, 0x9E, 0x45, 0x0C, 0xE8, 0xA1, 0x7A, 0x33, 0xFD, 0xB4, 0x6F, 0x26,
+        0x96, 0xDF, 0x04, 0x4D, 0x83, 0xCA, 0x11, 0x58, 0xBC, 0xF5, 0x2E, 0x67, 0xA9, 0xE0, 0x3B, 0x72,
+        0x6A, 0x23, 0xF8, 0xB1, 0x7F, 0x36, 0xED, 0xA4, 0x40, 0x09, 0xD2, 0x9B, 0x55, 0x1C, 0xC7, 0x8E,
+        0x3E, 0x77, 0xAC, 0xE5, 0x2B, 0x62, 0xB9, 0xF0, 0x14, 0x5D, 0x86, 0xCF, 0x01, 0x48, 0x93, 0xDA,
+        0xA3, 0xEA, 0x31, 0x78, 0xB6, 0xFF, 0x24, 0x6D, 0x89, 0xC0, 0x1B, 0x52, 0x9C, 0xD5, 0x0E, 0x47,
+        0xF7, 0xBE, 0x65, 0x2C, 0xE2, 0xAB, 0x70, 0x39, 0xDD, 0x94, 0x4F, 0x06, 0xC8, 0x81, 0x5A, 0x13,
+        0x0B, 0x42, 0x99, 0xD0, 0x1E, 0x57, 0x8C, 0xC5, 0x21, 0x68, 0xB3, 0xFA, 0x34, 0x7D, 0xA6, 0xEF,
+        0x5F, 0x16, 0xCD, 0x84, 0x4A, 0x03, 0xD8, 0x91, 0x75, 0x3C, 0xE7, 0xAE, 0x60, 0x29, 0xF2, 0xBB,
+    },
+};
+
+DSTATIC inline uint8_t get_crc8(const uint8_t* data, size_t size, uint8_t crc)
+{
+    while (size >= 8) {
+        crc = crc8_table[7][crc ^ data[0]] ^ crc8_table[6][data[1]] ^
+              crc8_table[5][data[2]]       ^ crc8_table[4][data[3]] ^
+              crc8_table[3][data[4]]       ^ crc8_table[2][data[5]] ^
+              crc8_table[1][data[6]]       ^ crc8_table[0][data[7]];
+        data += 8;
+        size -= 8;
     }
+    for (size_t i = 0; i < size; i++) {
+        crc = crc8_table[0][crc ^ data[i]];
+    }
+    return crc;
 }
 
-DSTATIC inline uint8_t get_crc8(uint8_t* data, uint8_t size, uint8_t crc)
+// CRC-16/CCITT-FALSE and CRC-32 of extended frames
+// Both are computed slicing-by-8 the same way as CRC-8: CRC-16 with tables of
+// polynomial 0x1021, CRC-32 with reflected tables of polynomial 0xEDB88320.
+static const uint16_t crc16_table[8][256] = {
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+    },
+    {
+        0x0000, 0x3331, 0x6662, 0x5553, 0xCCC4, 0xFFF5, 0xAAA6, 0x9997,
+        0x89A9, 0xBA98, 0xEFCB, 0xDCFA, 0x456D, 0x765C, 0x230F, 0x103E,
+        0x0373, 0x3042, 0x6511, 0x5620, 0xCFB7, 0xFC86, 0xA9D5, 0x9AE4,
+        0x8ADA, 0xB9EB, 0xECB8, 0xDF89, 0x461E, 0x752F, 0x207C, 0x134D,
+        0x06E6, 0x35D7, 0x6084, 0x53B5, 0xCA22, 0xF913, 0xAC40, 0x9F71,
+        0x8F4F, 0xBC7E, 0xE92D, 0xDA1C, 0x438B, 0x70BA, 0x25E9, 0x16D8,
+        0x0595, 0x36A4, 0x63F7, 0x50C6, 0xC951, 0xFA60, 0xAF33, 0x9C02,
+        0x8C3C, 0xBF0D, 0xEA5E, 0xD96F, 0x40F8, 0x73C9, 0x269A, 0x15AB,
+        0x0DCC, 0x3EFD, 0x6BAE, 0x589F, 0xC108, 0xF239, 0xA76A, 0x945B,
+        0x8465, 0xB754, 0xE207, 0xD136, 0x48A1, 0x7B90, 0x2EC3, 0x1DF2,
+        0x0EBF, 0x3D8E, 0x68DD, 0x5BEC, 0xC27B, 0xF14A, 0xA419, 0x9728,
+        0x8716, 0xB427, 0xE174, 0xD245, 0x4BD2, 0x78E3, 0x2DB0, 0x1E81,
+        0x0B2A, 0x381B, 0x6D48, 0x5E79, 0xC7EE, 0xF4DF, 0xA18C, 0x92BD,
+        0x8283, 0xB1B2, 0xE4E1, 0xD7D0, 0x4E47, 0x7D76, 0x2825, 0x1B14,
+        0x0859, 0x3B68, 0x6E3B, 0x5D0A, 0xC49D, 0xF7AC, 0xA2FF, 0x91CE,
+        0x81F0, 0xB2C1, 0xE792, 0xD4A3, 0x4D34, 0x7E05, 0x2B56, 0x1867,
+        0x1B98, 0x28A9, 0x7DFA, 0x4ECB, 0xD75C, 0xE46D, 0xB13E, 0x820F,
+        0x9231, 0xA100, 0xF453, 0xC762, 0x5EF5, 0x6DC4, 0x3897, 0x0BA6,
+        0x18EB, 0x2BDA, 0x7E89, 0x4DB8, 0xD42F, 0xE71E, 0xB24D, 0x817C,
+        0x9142, 0xA273, 0xF720, 0xC411, 0x5D86, 0x6EB7, 0x3BE4, 0x08D5,
+        0x1D7E, 0x2E4F, 0x7B1C, 0x482D, 0xD1BA, 0xE28B, 0xB7D8, 0x84E9,
+        0x94D7, 0xA7E6, 0xF2B5, 0xC184, 0x5813, 0x6B22, 0x3E71, 0x0D40,
+        0x1E0D, 0x2D3C, 0x786F, 0x4B5E, 0xD2C9, 0xE1F8, 0xB4AB, 0x879A,
+        0x97A4, 0xA495, 0xF1C6, 0xC2F7, 0x5B60, 0x6851, 0x3D02, 0x0E33,
+        0x1654, 0x2565, 0x7036, 0x4307, 0xDA90, 0xE9A1, 0xBCF2, 0x8FC3,
+        0x9FFD, 0xACCC, 0xF99F, 0xCAAE, 0x5339, 0x6008, 0x355B, 0x066A,
+        0x1527, 0x2616, 0x7345, 0x4074, 0xD9E3, 0xEAD2, 0xBF81, 0x8CB0,
+        0x9C8E, 0xAFBF, 0xFAEC, 0xC9DD, 0x504A, 0x637B, 0x3628, 0x0519,
+        0x10B2, 0x2383, 0x76D0, 0x45E1, 0xDC76, 0xEF47, 0xBA14, 0x8925,
+        0x991B, 0xAA2A, 0xFF79, 0xCC48, 0x55DF, 0x66EE, 0x33BD, 0x008C,
+        0x13C1, 0x20F0, 0x75A3, 0x4692, 0xDF05, 0xEC34, 0xB967, 0x8A56,
+        0x9A68, 0xA959, 0xFC0A, 0xCF3B, 0x56AC, 0x659D, 0x30CE, 0x03FF,
+    },
+    {
+        0x0000, 0x3730, 0x6E60, 0x5950, 0xDCC0, 0xEBF0, 0xB2A0, 0x8590,
+        0xA9A1, 0x9E91, 0xC7C1, 0xF0F1, 0x7561, 0x4251, 0x1B01, 0x2C31,
+        0x4363, 0x7453, 0x2D03, 0x1A33, 0x9FA3, 0xA893, 0xF1C3, 0xC6F3,
+        0xEAC2, 0xDDF2, 0x84A2, 0xB392, 0x3602, 0x0132, 0x5862, 0x6F52,
+        0x86C6, 0xB1F6, 0xE8A6, 0xDF96, 0x5A06, 0x6D36, 0x3466, 0x0356,
+        0x2F67, 0x1857, 0x4107, 0x7637, 0xF3A7, 0xC497, 0x9DC7, 0xAAF7,
+        0xC5A5, 0xF295, 0xABC5, 0x9CF5, 0x1965, 0x2E55, 0x7705, 0x4035,
+        0x6C04, 0x5B34, 0x0264, 0x3554, 0xB0C4, 0x87F4, 0xDEA4, 0xE994,
+        0x1DAD, 0x2A9D, 0x73CD, 0x44FD, 0xC16D, 0xF65D, 0xAF0D, 0x983D,
+        0xB40C, 0x833C, 0xDA6C, 0xED5C, 0x68CC, 0x5FFC, 0x06AC, 0x319C,
+        0x5ECE, 0x69FE, 0x30AE, 0x079E, 0x820E, 0xB53E, 0xEC6E, 0xDB5E,
+        0xF76F, 0xC05F, 0x990F, 0xAE3F, 0x2BAF, 0x1C9F, 0x45CF, 0x72FF,
+        0x9B6B, 0xAC5B, 0xF50B, 0xC23B, 0x47AB, 0x709B, 0x29CB, 0x1EFB,
+        0x32CA, 0x05FA, 0x5CAA, 0x6B9A, 0xEE0A, 0xD93A, 0x806A, 0xB75A,
+        0xD808, 0xEF38, 0xB668, 0x8158, 0x04C8, 0x33F8, 0x6AA8, 0x5D98,
+        0x71A9, 0x4699, 0x1FC9, 0x28F9, 0xAD69, 0x9A59, 0xC309, 0xF439,
+        0x3B5A, 0x0C6A, 0x553A, 0x620A, 0xE79A, 0xD0AA, 0x89FA, 0xBECA,
+        0x92FB, 0xA5CB, 0xFC9B, 0xCBAB, 0x4E3B, 0x790B, 0x205B, 0x176B,
+        0x7839, 0x4F09, 0x1659, 0x2169, 0xA4F9, 0x93C9, 0xCA99, 0xFDA9,
+        0xD198, 0xE6A8, 0xBFF8, 0x88C8, 0x0D58, 0x3A68, 0x6338, 0x5408,
+        0xBD9C, 0x8AAC, 0xD3FC, 0xE4CC, 0x615C, 0x566C, 0x0F3C, 0x380C,
+        0x143D, 0x230D, 0x7A5D, 0x4D6D, 0xC8FD, 0xFFCD, 0xA69D, 0x91AD,
+        0xFEFF, 0xC9CF, 0x909F, 0xA7AF, 0x223F, 0x150F, 0x4C5F, 0x7B6F,
+        0x575E, 0x606E, 0x393E, 0x0E0E, 0x8B9E, 0xBCAE, 0xE5FE, 0xD2CE,
+        0x26F7, 0x11C7, 0x4897, 0x7FA7, 0xFA37, 0xCD07, 0x9457, 0xA367,
+        0x8F56, 0xB866, 0xE136, 0xD606, 0x5396, 0x64A6, 0x3DF6, 0x0AC6,
+        0x6594, 0x52A4, 0x0BF4, 0x3CC4, 0xB954, 0x8E64, 0xD734, 0xE004,
+        0xCC35, 0xFB05, 0xA255, 0x9565, 0x10F5, 0x27C5, 0x7E95, 0x49A5,
+        0xA031, 0x9701, 0xCE51, 0xF961, 0x7CF1, 0x4BC1, 0x1291, 0x25A1,
+        0x0990, 0x3EA0, 0x67F0, 0x50C0, 0xD550, 0xE260, 0xBB30, 0x8C00,
+        0xE352, 0xD462, 0x8D32, 0xBA02, 0x3F92, 0x08A2, 0x51F2, 0x66C2,
+        0x4AF3, 0x7DC3, 0x2493, 0x13A3, 0x9633, 0xA103, 0xF853, 0xCF63,
+    },
+    {
+        0x0000, 0x76B4, 0xED68, 0x9BDC, 0xCAF1, 0xBC45, 0x2799, 0x512D,
+        0x85C3, 0xF377, 0x68AB, 0x1E1F, 0x4F32, 0x3986, 0xA25A, 0xD4EE,
+        0x1BA7, 0x6D13, 0xF6CF, 0x807B, 0xD156, 0xA7E2, 0x3C3E, 0x4A8A,
+        0x9E64, 0xE8D0, 0x730C, 0x05B8, 0x5495, 0x2221, 0xB9FD, 0xCF49,
+        0x374E, 0x41FA, 0xDA26, 0xAC92, 0xFDBF, 0x8B0B, 0x10D7, 0x6663,
+        0xB28D, 0xC439, 0x5FE5, 0x2951, 0x787C, 0x0EC8, 0x9514, 0xE3A0,
+        0x2CE9, 0x5A5D, 0xC181, 0xB735, 0xE618, 0x90AC, 0x0B70, 0x7DC4,
+        0xA92A, 0xDF9E, 0x4442, 0x32F6, 0x63DB, 0x156F, 0x8EB3, 0xF807,
+        0x6E9C, 0x1828, 0x83F4, 0xF540, 0xA46D, 0xD2D9, 0x4905, 0x3FB1,
+        0xEB5F, 0x9DEB, 0x0637, 0x7083, 0x21AE, 0x571A, 0xCCC6, 0xBA72,
+        0x753B, 0x038F, 0x9853, 0xEEE7, 0xBFCA, 0xC97E, 0x52A2, 0x2416,
+        0xF0F8, 0x864C, 0x1D90, 0x6B24, 0x3A09, 0x4CBD, 0xD761, 0xA1D5,
+        0x59D2, 0x2F66, 0xB4BA, 0xC20E, 0x9323, 0xE597, 0x7E4B, 0x08FF,
+        0xDC11, 0xAAA5, 0x3179, 0x47CD, 0x16E0, 0x6054, 0xFB88, 0x8D3C,
+        0x4275, 0x34C1, 0xAF1D, 0xD9A9, 0x8884, 0xFE30, 0x65EC, 0x1358,
+        0xC7B6, 0xB102, 0x2ADE, 0x5C6A, 0x0D47, 0x7BF3, 0xE02F, 0x969B,
+        0xDD38, 0xAB8C, 0x3050, 0x46E4, 0x17C9, 0x617D, 0xFAA1, 0x8C15,
+        0x58FB, 0x2E4F, 0xB593, 0xC327, 0x920A, 0xE4BE, 0x7F62, 0x09D6,
+        0xC69F, 0xB02B, 0x2BF7, 0x5D43, 0x0C6E, 0x7ADA, 0xE106, 0x97B2,
+        0x435C, 0x35E8, 0xAE34, 0xD880, 0x89AD, 0xFF19, 0x64C5, 0x1271,
+        0xEA76, 0x9CC2, 0x071E, 0x71AA, 0x2087, 0x5633, 0xCDEF, 0xBB5B,
+        0x6FB5, 0x1901, 0x82DD, 0xF469, 0xA544, 0xD3F0, 0x482C, 0x3E98,
+        0xF1D1, 0x8765, 0x1CB9, 0x6A0D, 0x3B20, 0x4D94, 0xD648, 0xA0FC,
+        0x7412, 0x02A6, 0x997A, 0xEFCE, 0xBEE3, 0xC857, 0x538B, 0x253F,
+        0xB3A4, 0xC510, 0x5ECC, 0x2878, 0x7955, 0x0FE1, 0x943D, 0xE289,
+        0x3667, 0x40D3, 0xDB0F, 0xADBB, 0xFC96, 0x8A22, 0x11FE, 0x674A,
+        0xA803, 0xDEB7, 0x456B, 0x33DF, 0x62F2, 0x1446, 0x8F9A, 0xF92E,
+        0x2DC0, 0x5B74, 0xC0A8, 0xB61C, 0xE731, 0x9185, 0x0A59, 0x7CED,
+        0x84EA, 0xF25E, 0x6982, 0x1F36, 0x4E1B, 0x38AF, 0xA373, 0xD5C7,
+        0x0129, 0x779D, 0xEC41, 0x9AF5, 0xCBD8, 0xBD6C, 0x26B0, 0x5004,
+        0x9F4D, 0xE9F9, 0x7225, 0x0491, 0x55BC, 0x2308, 0xB8D4, 0xCE60,
+        0x1A8E, 0x6C3A, 0xF7E6, 0x8152, 0xD07F, 0xA6CB, 0x3D17, 0x4BA3,
+    },
+    {
+        0x0000, 0xAA51, 0x4483, 0xEED2, 0x8906, 0x2357, 0xCD85, 0x67D4,
+        0x022D, 0xA87C, 0x46AE, 0xECFF, 0x8B2B, 0x217A, 0xCFA8, 0x65F9,
+        0x045A, 0xAE0B, 0x40D9, 0xEA88, 0x8D5C, 0x270D, 0xC9DF, 0x638E,
+        0x0677, 0xAC26, 0x42F4, 0xE8A5, 0x8F71, 0x2520, 0xCBF2, 0x61A3,
+        0x08B4, 0xA2E5, 0x4C37, 0xE666, 0x81B2, 0x2BE3, 0xC531, 0x6F60,
+        0x0A99, 0xA0C8, 0x4E1A, 0xE44B, 0x839F, 0x29CE, 0xC71C, 0x6D4D,
+        0x0CEE, 0xA6BF, 0x486D, 0xE23C, 0x85E8, 0x2FB9, 0xC16B, 0x6B3A,
+        0x0EC3, 0xA492, 0x4A40, 0xE011, 0x87C5, 0x2D94, 0xC346, 0x6917,
+        0x1168, 0xBB39, 0x55EB, 0xFFBA, 0x986E, 0x323F, 0xDCED, 0x76BC,
+        0x1345, 0xB914, 0x57C6, 0xFD97, 0x9A43, 0x3012, 0xDEC0, 0x7491,
+        0x1532, 0xBF63, 0x51B1, 0xFBE0, 0x9C34, 0x3665, 0xD8B7, 0x72E6,
+        0x171F, 0xBD4E, 0x539C, 0xF9CD, 0x9E19, 0x3448, 0xDA9A, 0x70CB,
+        0x19DC, 0xB38D, 0x5D5F, 0xF70E, 0x90DA, 0x3A8B, 0xD459, 0x7E08,
+        0x1BF1, 0xB1A0, 0x5F72, 0xF523, 0x92F7, 0x38A6, 0xD674, 0x7C25,
+        0x1D86, 0xB7D7, 0x5905, 0xF354, 0x9480, 0x3ED1, 0xD003, 0x7A52,
+        0x1FAB, 0xB5FA, 0x5B28, 0xF179, 0x96AD, 0x3CFC, 0xD22E, 0x787F,
+        0x22D0, 0x8881, 0x6653, 0xCC02, 0xABD6, 0x0187, 0xEF55, 0x4504,
+        0x20FD, 0x8AAC, 0x647E, 0xCE2F, 0xA9FB, 0x03AA, 0xED78, 0x4729,
+        0x268A, 0x8CDB, 0x6209, 0xC858, 0xAF8C, 0x05DD, 0xEB0F, 0x415E,
+        0x24A7, 0x8EF6, 0x6024, 0xCA75, 0xADA1, 0x07F0, 0xE922, 0x4373,
+        0x2A64, 0x8035, 0x6EE7, 0xC4B6, 0xA362, 0x0933, 0xE7E1, 0x4DB0,
+        0x2849, 0x8218, 0x6CCA, 0xC69B, 0xA14F, 0x0B1E, 0xE5CC, 0x4F9D,
+        0x2E3E, 0x846F, 0x6ABD, 0xC0EC, 0xA738, 0x0D69, 0xE3BB, 0x49EA,
+        0x2C13, 0x8642, 0x6890, 0xC2C1, 0xA515, 0x0F44, 0xE196, 0x4BC7,
+        0x33B8, 0x99E9, 0x773B, 0xDD6A, 0xBABE, 0x10EF, 0xFE3D, 0x546C,
+        0x3195, 0x9BC4, 0x7516, 0xDF47, 0xB893, 0x12C2, 0xFC10, 0x5641,
+        0x37E2, 0x9DB3, 0x7361, 0xD930, 0xBEE4, 0x14B5, 0xFA67, 0x5036,
+        0x35CF, 0x9F9E, 0x714C, 0xDB1D, 0xBCC9, 0x1698, 0xF84A, 0x521B,
+        0x3B0C, 0x915D, 0x7F8F, 0xD5DE, 0xB20A, 0x185B, 0xF689, 0x5CD8,
+        0x3921, 0x9370, 0x7DA2, 0xD7F3, 0xB027, 0x1A76, 0xF4A4, 0x5EF5,
+        0x3F56, 0x9507, 0x7BD5, 0xD184, 0xB650, 0x1C01, 0xF2D3, 0x5882,
+        0x3D7B, 0x972A, 0x79F8, 0xD3A9, 0xB47D, 0x1E2C, 0xF0FE, 0x5AAF,
+    },
+    {
+        0x0000, 0x45A0, 0x8B40, 0xCEE0, 0x06A1, 0x4301, 0x8DE1, 0xC841,
+        0x0D42, 0x48E2, 0x8602, 0xC3A2, 0x0BE3, 0x4E43, 0x80A3, 0xC503,
+        0x1A84, 0x5F24, 0x91C4, 0xD464, 0x1C25, 0x5985, 0x9765, 0xD2C5,
+        0x17C6, 0x5266, 0x9C86, 0xD926, 0x1167, 0x54C7, 0x9A27, 0xDF87,
+        0x3508, 0x70A8, 0xBE48, 0xFBE8, 0x33A9, 0x7609, 0xB8E9, 0xFD49,
+        0x384A, 0x7DEA, 0xB30A, 0xF6AA, 0x3EEB, 0x7B4B, 0xB5AB, 0xF00B,
+        0x2F8C, 0x6A2C, 0xA4CC, 0xE16C, 0x292D, 0x6C8D, 0xA26D, 0xE7CD,
+        0x22CE, 0x676E, 0xA98E, 0xEC2E, 0x246F, 0x61CF, 0xAF2F, 0xEA8F,
+        0x6A10, 0x2FB0, 0xE150, 0xA4F0, 0x6CB1, 0x2911, 0xE7F1, 0xA251,
+        0x6752, 0x22F2, 0xEC12, 0xA9B2, 0x61F3, 0x2453, 0xEAB3, 0xAF13,
+        0x7094, 0x3534, 0xFBD4, 0xBE74, 0x7635, 0x3395, 0xFD75, 0xB8D5,
+        0x7DD6, 0x3876, 0xF696, 0xB336, 0x7B77, 0x3ED7, 0xF037, 0xB597,
+        0x5F18, 0x1AB8, 0xD458, 0x91F8, 0x59B9, 0x1C19, 0xD2F9, 0x9759,
+        0x525A, 0x17FA, 0xD91A, 0x9CBA, 0x54FB, 0x115B, 0xDFBB, 0x9A1B,
+        0x459C, 0x003C, 0xCEDC, 0x8B7C, 0x433D, 0x069D, 0xC87D, 0x8DDD,
+        0x48DE, 0x0D7E, 0xC39E, 0x863E, 0x4E7F, 0x0BDF, 0xC53F, 0x809F,
+        0xD420, 0x9180, 0x5F60, 0x1AC0, 0xD281, 0x9721, 0x59C1, 0x1C61,
+        0xD962, 0x9CC2, 0x5222, 0x1782, 0xDFC3, 0x9A63, 0x5483, 0x1123,
+        0xCEA4, 0x8B04, 0x45E4, 0x0044, 0xC805, 0x8DA5, 0x4345, 0x06E5,
+        0xC3E6, 0x8646, 0x48A6, 0x0D06, 0xC547, 0x80E7, 0x4E07, 0x0BA7,
+        0xE128, 0xA488, 0x6A68, 0x2FC8, 0xE789, 0xA229, 0x6CC9, 0x2969,
+        0xEC6A, 0xA9CA, 0x672A, 0x228A, 0xEACB, 0xAF6B, 0x618B, 0x242B,
+        0xFBAC, 0xBE0C, 0x70EC, 0x354C, 0xFD0D, 0xB8AD, 0x764D, 0x33ED,
+        0xF6EE, 0xB34E, 0x7DAE, 0x380E, 0xF04F, 0xB5EF, 0x7B0F, 0x3EAF,
+        0xBE30, 0xFB90, 0x3570, 0x70D0, 0xB891, 0xFD31, 0x33D1, 0x7671,
+        0xB372, 0xF6D2, 0x3832, 0x7D92, 0xB5D3, 0xF073, 0x3E93, 0x7B33,
+        0xA4B4, 0xE114, 0x2FF4, 0x6A54, 0xA215, 0xE7B5, 0x2955, 0x6CF5,
+        0xA9F6, 0xEC56, 0x22B6, 0x6716, 0xAF57, 0xEAF7, 0x2417, 0x61B7,
+        0x8B38, 0xCE98, 0x0078, 0x45D8, 0x8D99, 0xC839, 0x06D9, 0x4379,
+        0x867A, 0xC3DA, 0x0D3A, 0x489A, 0x80DB, 0xC57B, 0x0B9B, 0x4E3B,
+        0x91BC, 0xD41C, 0x1AFC, 0x5F5C, 0x971D, 0xD2BD, 0x1C5D, 0x59FD,
+        0x9CFE, 0xD95E, 0x17BE, 0x521E, 0x9A5F, 0xDFFF, 0x111F, 0x54BF,
+    },
+    {
+        0x0000, 0xB861, 0x60E3, 0xD882, 0xC1C6, 0x79A7, 0xA125, 0x1944,
+        0x93AD, 0x2BCC, 0xF34E, 0x4B2F, 0x526B, 0xEA0A, 0x3288, 0x8AE9,
+        0x377B, 0x8F1A, 0x5798, 0xEFF9, 0xF6BD, 0x4EDC, 0x965E, 0x2E3F,
+        0xA4D6, 0x1CB7, 0xC435, 0x7C54, 0x6510, 0xDD71, 0x05F3, 0xBD92,
+        0x6EF6, 0xD697, 0x0E15, 0xB674, 0xAF30, 0x1751, 0xCFD3, 0x77B2,
+        0xFD5B, 0x453A, 0x9DB8, 0x25D9, 0x3C9D, 0x84FC, 0x5C7E, 0xE41F,
+        0x598D, 0xE1EC, 0x396E, 0x810F, 0x984B, 0x202A, 0xF8A8, 0x40C9,
+        0xCA20, 0x7241, 0xAAC3, 0x12A2, 0x0BE6, 0xB387, 0x6B05, 0xD364,
+        0xDDEC, 0x658D, 0xBD0F, 0x056E, 0x1C2A, 0xA44B, 0x7CC9, 0xC4A8,
+        0x4E41, 0xF620, 0x2EA2, 0x96C3, 0x8F87, 0x37E6, 0xEF64, 0x5705,
+        0xEA97, 0x52F6, 0x8A74, 0x3215, 0x2B51, 0x9330, 0x4BB2, 0xF3D3,
+        0x793A, 0xC15B, 0x19D9, 0xA1B8, 0xB8FC, 0x009D, 0xD81F, 0x607E,
+        0xB31A, 0x0B7B, 0xD3F9, 0x6B98, 0x72DC, 0xCABD, 0x123F, 0xAA5E,
+        0x20B7, 0x98D6, 0x4054, 0xF835, 0xE171, 0x5910, 0x8192, 0x39F3,
+        0x8461, 0x3C00, 0xE482, 0x5CE3, 0x45A7, 0xFDC6, 0x2544, 0x9D25,
+        0x17CC, 0xAFAD, 0x772F, 0xCF4E, 0xD60A, 0x6E6B, 0xB6E9, 0x0E88,
+        0xABF9, 0x1398, 0xCB1A, 0x737B, 0x6A3F, 0xD25E, 0x0ADC, 0xB2BD,
+        0x3854, 0x8035, 0x58B7, 0xE0D6, 0xF992, 0x41F3, 0x9971, 0x2110,
+        0x9C82, 0x24E3, 0xFC61, 0x4400, 0x5D44, 0xE525, 0x3DA7, 0x85C6,
+        0x0F2F, 0xB74E, 0x6FCC, 0xD7AD, 0xCEE9, 0x7688, 0xAE0A, 0x166B,
+        0xC50F, 0x7D6E, 0xA5EC, 0x1D8D, 0x04C9, 0xBCA8, 0x642A, 0xDC4B,
+        0x56A2, 0xEEC3, 0x3641, 0x8E20, 0x9764, 0x2F05, 0xF787, 0x4FE6,
+        0xF274, 0x4A15, 0x9297, 0x2AF6, 0x33B2, 0x8BD3, 0x5351, 0xEB30,
+        0x61D9, 0xD9B8, 0x013A, 0xB95B, 0xA01F, 0x187E, 0xC0FC, 0x789D,
+        0x7615, 0xCE74, 0x16F6, 0xAE97, 0xB7D3, 0x0FB2, 0xD730, 0x6F51,
+        0xE5B8, 0x5DD9, 0x855B, 0x3D3A, 0x247E, 0x9C1F, 0x449D, 0xFCFC,
+        0x416E, 0xF90F, 0x218D, 0x99EC, 0x80A8, 0x38C9, 0xE04B, 0x582A,
+        0xD2C3, 0x6AA2, 0xB220, 0x0A41, 0x1305, 0xAB64, 0x73E6, 0xCB87,
+        0x18E3, 0xA082, 0x7800, 0xC061, 0xD925, 0x6144, 0xB9C6, 0x01A7,
+        0x8B4E, 0x332F, 0xEBAD, 0x53CC, 0x4A88, 0xF2E9, 0x2A6B, 0x920A,
+        0x2F98, 0x97F9, 0x4F7B, 0xF71A, 0xEE5E, 0x563F, 0x8EBD, 0x36DC,
+        0xBC35, 0x0454, 0xDCD6, 0x64B7, 0x7DF3, 0xC592, 0x1D10, 0xA571,
+    },
+    {
+        0x0000, 0x47D3, 0x8FA6, 0xC875, 0x0F6D, 0x48BE, 0x80CB, 0xC718,
+        0x1EDA, 0x5909, 0x917C, 0xD6AF, 0x11B7, 0x5664, 0x9E11, 0xD9C2,
+        0x3DB4, 0x7A67, 0xB212, 0xF5C1, 0x32D9, 0x750A, 0xBD7F, 0xFAAC,
+        0x236E, 0x64BD, 0xACC8, 0xEB1B, 0x2C03, 0x6BD0, 0xA3A5, 0xE476,
+        0x7B68, 0x3CBB, 0xF4CE, 0xB31D, 0x7405, 0x33D6, 0xFBA3, 0xBC70,
+        0x65B2, 0x2261, 0xEA14, 0xADC7, 0x6ADF, 0x2D0C, 0xE579, 0xA2AA,
+        0x46DC, 0x010F, 0xC97A, 0x8EA9, 0x49B1, 0x0E62, 0xC617, 0x81C4,
+        0x5806, 0x1FD5, 0xD7A0, 0x9073, 0x576B, 0x10B8, 0xD8CD, 0x9F1E,
+        0xF6D0, 0xB103, 0x7976, 0x3EA5, 0xF9BD, 0xBE6E, 0x761B, 0x31C8,
+        0xE80A, 0xAFD9, 0x67AC, 0x207F, 0xE767, 0xA0B4, 0x68C1, 0x2F12,
+        0xCB64, 0x8CB7, 0x44C2, 0x0311, 0xC409, 0x83DA, 0x4BAF, 0x0C7C,
+        0xD5BE, 0x926D, 0x5A18, 0x1DCB, 0xDAD3, 0x9D00, 0x5575, 0x12A6,
+        0x8DB8, 0xCA6B, 0x021E, 0x45CD, 0x82D5, 0xC506, 0x0D73, 0x4AA0,
+        0x9362, 0xD4B1, 0x1CC4, 0x5B17, 0x9C0F, 0xDBDC, 0x13A9, 0x547A,
+        0xB00C, 0xF7DF, 0x3FAA, 0x7879, 0xBF61, 0xF8B2, 0x30C7, 0x7714,
+        0xAED6, 0xE905, 0x2170, 0x66A3, 0xA1BB, 0xE668, 0x2E1D, 0x69CE,
+        0xFD81, 0xBA52, 0x7227, 0x35F4, 0xF2EC, 0xB53F, 0x7D4A, 0x3A99,
+        0xE35B, 0xA488, 0x6CFD, 0x2B2E, 0xEC36, 0xABE5, 0x6390, 0x2443,
+        0xC035, 0x87E6, 0x4F93, 0x0840, 0xCF58, 0x888B, 0x40FE, 0x072D,
+        0xDEEF, 0x993C, 0x5149, 0x169A, 0xD182, 0x9651, 0x5E24, 0x19F7,
+        0x86E9, 0xC13A, 0x094F, 0x4E9C, 0x8984, 0xCE57, 0x0622, 0x41F1,
+        0x9833, 0xDFE0, 0x1795, 0x5046, 0x975E, 0xD08D, 0x18F8, 0x5F2B,
+        0xBB5D, 0xFC8E, 0x34FB, 0x7328, 0xB430, 0xF3E3, 0x3B96, 0x7C45,
+        0xA587, 0xE254, 0x2A21, 0x6DF2, 0xAAEA, 0xED39, 0x254C, 0x629F,
+        0x0B51, 0x4C82, 0x84F7, 0xC324, 0x043C, 0x43EF, 0x8B9A, 0xCC49,
+        0x158B, 0x5258, 0x9A2D, 0xDDFE, 0x1AE6, 0x5D35, 0x9540, 0xD293,
+        0x36E5, 0x7136, 0xB943, 0xFE90, 0x3988, 0x7E5B, 0xB62E, 0xF1FD,
+        0x283F, 0x6FEC, 0xA799, 0xE04A, 0x2752, 0x6081, 0xA8F4, 0xEF27,
+        0x7039, 0x37EA, 0xFF9F, 0xB84C, 0x7F54, 0x3887, 0xF0F2, 0xB721,
+        0x6EE3, 0x2930, 0xE145, 0xA696, 0x618E, 0x265D, 0xEE28, 0xA9FB,
+        0x4D8D, 0x0A5E, 0xC22B, 0x85F8, 0x42E0, 0x0533, 0xCD46, 0x8A95,
+        0x5357, 0x1484, 0xDCF1, 0x9B22, 0x5C3A, 0x1BE9, 0xD39C, 0x944F,
+    },
+};
+
+static const uint32_t crc32_table[8][256] = {
+    {
+        0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+        0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+        0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+        0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+        0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+        0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+        0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+        0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+        0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+        0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+        0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+        0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+        0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+        0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+        0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+        0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+        0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+        0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+        0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+        0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+        0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+        0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+        0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+        0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+        0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+        0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+        0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+        0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+        0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+        0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+        0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+        0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+    },
+    {
+        0x00000000, 0x191B3141, 0x32366282, 0x2B2D53C3, 0x646CC504, 0x7D77F445, 0x565AA786, 0x4F4196C7,
+        0xC8D98A08, 0xD1C2BB49, 0xFAEFE88A, 0xE3F4D9CB, 0xACB54F0C, 0xB5AE7E4D, 0x9E832D8E, 0x87981CCF,
+        0x4AC21251, 0x53D92310, 0x78F470D3, 0x61EF4192, 0x2EAED755, 0x37B5E614, 0x1C98B5D7, 0x05838496,
+        0x821B9859, 0x9B00A918, 0xB02DFADB, 0xA936CB9A, 0xE6775D5D, 0xFF6C6C1C, 0xD4413FDF, 0xCD5A0E9E,
+        0x958424A2, 0x8C9F15E3, 0xA7B24620, 0xBEA97761, 0xF1E8E1A6, 0xE8F3D0E7, 0xC3DE8324, 0xDAC5B265,
+        0x5D5DAEAA, 0x44469FEB, 0x6F6BCC28, 0x7670FD69, 0x39316BAE, 0x202A5AEF, 0x0B07092C, 0x121C386D,
+        0xDF4636F3, 0xC65D07B2, 0xED705471, 0xF46B6530, 0xBB2AF3F7, 0xA231C2B6, 0x891C9175, 0x9007A034,
+        0x179FBCFB, 0x0E848DBA, 0x25A9DE79, 0x3CB2EF38, 0x73F379FF, 0x6AE848BE, 0x41C51B7D, 0x58DE2A3C,
+        0xF0794F05, 0xE9627E44, 0xC24F2D87, 0xDB541CC6, 0x94158A01, 0x8D0EBB40, 0xA623E883, 0xBF38D9C2,
+        0x38A0C50D, 0x21BBF44C, 0x0A96A78F, 0x138D96CE, 0x5CCC0009, 0x45D73148, 0x6EFA628B, 0x77E153CA,
+        0xBABB5D54, 0xA3A06C15, 0x888D3FD6, 0x91960E97, 0xDED79850, 0xC7CCA911, 0xECE1FAD2, 0xF5FACB93,
+        0x7262D75C, 0x6B79E61D, 0x4054B5DE, 0x594F849F, 0x160E1258, 0x0F152319, 0x243870DA, 0x3D23419B,
+        0x65FD6BA7, 0x7CE65AE6, 0x57CB0925, 0x4ED03864, 0x0191AEA3, 0x188A9FE2, 0x33A7CC21, 0x2ABCFD60,
+        0xAD24E1AF, 0xB43FD0EE, 0x9F12832D, 0x8609B26C, 0xC94824AB, 0xD05315EA, 0xFB7E4629, 0xE2657768,
+        0x2F3F79F6, 0x362448B7, 0x1D091B74, 0x04122A35, 0x4B53BCF2, 0x52488DB3, 0x7965DE70, 0x607EEF31,
+        0xE7E6F3FE, 0xFEFDC2BF, 0xD5D0917C, 0xCCCBA03D, 0x838A36FA, 0x9A9107BB, 0xB1BC5478, 0xA8A76539,
+        0x3B83984B, 0x2298A90A, 0x09B5FAC9, 0x10AECB88, 0x5FEF5D4F, 0x46F46C0E, 0x6DD93FCD, 0x74C20E8C,
+        0xF35A1243, 0xEA412302, 0xC16C70C1, 0xD8774180, 0x9736D747, 0x8E2DE606, 0xA500B5C5, 0xBC1B8484,
+        0x71418A1A, 0x685ABB5B, 0x4377E898, 0x5A6CD9D9, 0x152D4F1E, 0x0C367E5F, 0x271B2D9C, 0x3E001CDD,
+        0xB9980012, 0xA0833153, 0x8BAE6290, 0x92B553D1, 0xDDF4C516, 0xC4EFF457, 0xEFC2A794, 0xF6D996D5,
+        0xAE07BCE9, 0xB71C8DA8, 0x9C31DE6B, 0x852AEF2A, 0xCA6B79ED, 0xD37048AC, 0xF85D1B6F, 0xE1462A2E,
+        0x66DE36E1, 0x7FC507A0, 0x54E85463, 0x4DF36522, 0x02B2F3E5, 0x1BA9C2A4, 0x30849167, 0x299FA026,
+        0xE4C5AEB8, 0xFDDE9FF9, 0xD6F3CC3A, 0xCFE8FD7B, 0x80A96BBC, 0x99B25AFD, 0xB29F093E, 0xAB84387F,
+        0x2C1C24B0, 0x350715F1, 0x1E2A4632, 0x07317773, 0x4870E1B4, 0x516BD0F5, 0x7A468336, 0x635DB277,
+        0xCBFAD74E, 0xD2E1E60F, 0xF9CCB5CC, 0xE0D7848D, 0xAF96124A, 0xB68D230B, 0x9DA070C8, 0x84BB4189,
+        0x03235D46, 0x1A386C07, 0x31153FC4, 0x280E0E85, 0x674F9842, 0x7E54A903, 0x5579FAC0, 0x4C62CB81,
+        0x8138C51F, 0x9823F45E, 0xB30EA79D, 0xAA1596DC, 0xE554001B, 0xFC4F315A, 0xD7626299, 0xCE7953D8,
+        0x49E14F17, 0x50FA7E56, 0x7BD72D95, 0x62CC1CD4, 0x2D8D8A13, 0x3496BB52, 0x1FBBE891, 0x06A0D9D0,
+        0x5E7EF3EC, 0x4765C2AD, 0x6C48916E, 0x7553A02F, 0x3A1236E8, 0x230907A9, 0x0824546A, 0x113F652B,
+        0x96A779E4, 0x8FBC48A5, 0xA4911B66, 0xBD8A2A27, 0xF2CBBCE0, 0xEBD08DA1, 0xC0FDDE62, 0xD9E6EF23,
+        0x14BCE1BD, 0x0DA7D0FC, 0x268A833F, 0x3F91B27E, 0x70D024B9, 0x69CB15F8, 0x42E6463B, 0x5BFD777A,
+        0xDC656BB5, 0xC57E5AF4, 0xEE530937, 0xF7483876, 0xB809AEB1, 0xA1129FF0, 0x8A3FCC33, 0x9324FD72,
+    },
+    {
+        0x00000000, 0x01C26A37, 0x0384D46E, 0x0246BE59, 0x0709A8DC, 0x06CBC2EB, 0x048D7CB2, 0x054F1685,
+        0x0E1351B8, 0x0FD13B8F, 0x0D9785D6, 0x0C55EFE1, 0x091AF964, 0x08D89353, 0x0A9E2D0A, 0x0B5C473D,
+        0x1C26A370, 0x1DE4C947, 0x1FA2771E, 0x1E601D29, 0x1B2F0BAC, 0x1AED619B, 0x18ABDFC2, 0x1969B5F5,
+        0x1235F2C8, 0x13F798FF, 0x11B126A6, 0x10734C91, 0x153C5A14, 0x14FE3023, 0x16B88E7A, 0x177AE44D,
+        0x384D46E0, 0x398F2CD7, 0x3BC9928E, 0x3A0BF8B9, 0x3F44EE3C, 0x3E86840B, 0x3CC03A52, 0x3D025065,
+        0x365E1758, 0x379C7D6F, 0x35DAC336, 0x3418A901, 0x3157BF84, 0x3095D5B3, 0x32D36BEA, 0x331101DD,
+        0x246BE590, 0x25A98FA7, 0x27EF31FE, 0x262D5BC9, 0x23624D4C, 0x22A0277B, 0x20E69922, 0x2124F315,
+        0x2A78B428, 0x2BBADE1F, 0x29FC6046, 0x283E0A71, 0x2D711CF4, 0x2CB376C3, 0x2EF5C89A, 0x2F37A2AD,
+        0x709A8DC0, 0x7158E7F7, 0x731E59AE, 0x72DC3399, 0x7793251C, 0x76514F2B, 0x7417F172, 0x75D59B45,
+        0x7E89DC78, 0x7F4BB64F, 0x7D0D0816, 0x7CCF6221, 0x798074A4, 0x78421E93, 0x7A04A0CA, 0x7BC6CAFD,
+        0x6CBC2EB0, 0x6D7E4487, 0x6F38FADE, 0x6EFA90E9, 0x6BB5866C, 0x6A77EC5B, 0x68315202, 0x69F33835,
+        0x62AF7F08, 0x636D153F, 0x612BAB66, 0x60E9C151, 0x65A6D7D4, 0x6464BDE3, 0x662203BA, 0x67E0698D,
+        0x48D7CB20, 0x4915A117, 0x4B531F4E, 0x4A917579, 0x4FDE63FC, 0x4E1C09CB, 0x4C5AB792, 0x4D98DDA5,
+        0x46C49A98, 0x4706F0AF, 0x45404EF6, 0x448224C1, 0x41CD3244, 0x400F5873, 0x4249E62A, 0x438B8C1D,
+        0x54F16850, 0x55330267, 0x5775BC3E, 0x56B7D609, 0x53F8C08C, 0x523AAABB, 0x507C14E2, 0x51BE7ED5,
+        0x5AE239E8, 0x5B2053DF, 0x5966ED86, 0x58A487B1, 0x5DEB9134, 0x5C29FB03, 0x5E6F455A, 0x5FAD2F6D,
+        0xE1351B80, 0xE0F771B7, 0xE2B1CFEE, 0xE373A5D9, 0xE63CB35C, 0xE7FED96B, 0xE5B86732, 0xE47A0D05,
+        0xEF264A38, 0xEEE4200F, 0xECA29E56, 0xED60F461, 0xE82FE2E4, 0xE9ED88D3, 0xEBAB368A, 0xEA695CBD,
+        0xFD13B8F0, 0xFCD1D2C7, 0xFE976C9E, 0xFF5506A9, 0xFA1A102C, 0xFBD87A1B, 0xF99EC442, 0xF85CAE75,
+        0xF300E948, 0xF2C2837F, 0xF0843D26, 0xF1465711, 0xF4094194, 0xF5CB2BA3, 0xF78D95FA, 0xF64FFFCD,
+        0xD9785D60, 0xD8BA3757, 0xDAFC890E, 0xDB3EE339, 0xDE71F5BC, 0xDFB39F8B, 0xDDF521D2, 0xDC374BE5,
+        0xD76B0CD8, 0xD6A966EF, 0xD4EFD8B6, 0xD52DB281, 0xD062A404, 0xD1A0CE33, 0xD3E6706A, 0xD2241A5D,
+        0xC55EFE10, 0xC49C9427, 0xC6DA2A7E, 0xC7184049, 0xC25756CC, 0xC3953CFB, 0xC1D382A2, 0xC011E895,
+        0xCB4DAFA8, 0xCA8FC59F, 0xC8C97BC6, 0xC90B11F1, 0xCC440774, 0xCD866D43, 0xCFC0D31A, 0xCE02B92D,
+        0x91AF9640, 0x906DFC77, 0x922B422E, 0x93E92819, 0x96A63E9C, 0x976454AB, 0x9522EAF2, 0x94E080C5,
+        0x9FBCC7F8, 0x9E7EADCF, 0x9C381396, 0x9DFA79A1, 0x98B56F24, 0x99770513, 0x9B31BB4A, 0x9AF3D17D,
+        0x8D893530, 0x8C4B5F07, 0x8E0DE15E, 0x8FCF8B69, 0x8A809DEC, 0x8B42F7DB, 0x89044982, 0x88C623B5,
+        0x839A6488, 0x82580EBF, 0x801EB0E6, 0x81DCDAD1, 0x8493CC54, 0x8551A663, 0x8717183A, 0x86D5720D,
+        0xA9E2D0A0, 0xA820BA97, 0xAA6604CE, 0xABA46EF9, 0xAEEB787C, 0xAF29124B, 0xAD6FAC12, 0xACADC625,
+        0xA7F18118, 0xA633EB2F, 0xA4755576, 0xA5B73F41, 0xA0F829C4, 0xA13A43F3, 0xA37CFDAA, 0xA2BE979D,
+        0xB5C473D0, 0xB40619E7, 0xB640A7BE, 0xB782CD89, 0xB2CDDB0C, 0xB30FB13B, 0xB1490F62, 0xB08B6555,
+        0xBBD72268, 0xBA15485F, 0xB853F606, 0xB9919C31, 0xBCDE8AB4, 0xBD1CE083, 0xBF5A5EDA, 0xBE9834ED,
+    },
+    {
+        0x00000000, 0xB8BC6765, 0xAA09C88B, 0x12B5AFEE, 0x8F629757, 0x37DEF032, 0x256B5FDC, 0x9DD738B9,
+        0xC5B428EF, 0x7D084F8A, 0x6FBDE064, 0xD7018701, 0x4AD6BFB8, 0xF26AD8DD, 0xE0DF7733, 0x58631056,
+        0x5019579F, 0xE8A530FA, 0xFA109F14, 0x42ACF871, 0xDF7BC0C8, 0x67C7A7AD, 0x75720843, 0xCDCE6F26,
+        0x95AD7F70, 0x2D111815, 0x3FA4B7FB, 0x8718D09E, 0x1ACFE827, 0xA2738F42, 0xB0C620AC, 0x087A47C9,
+        0xA032AF3E, 0x188EC85B, 0x0A3B67B5, 0xB28700D0, 0x2F503869, 0x97EC5F0C, 0x8559F0E2, 0x3DE59787,
+        0x658687D1, 0xDD3AE0B4, 0xCF8F4F5A, 0x7733283F, 0xEAE41086, 0x525877E3, 0x40EDD80D, 0xF851BF68,
+        0xF02BF8A1, 0x48979FC4, 0x5A22302A, 0xE29E574F, 0x7F496FF6, 0xC7F50893, 0xD540A77D, 0x6DFCC018,
+        0x359FD04E, 0x8D23B72B, 0x9F9618C5, 0x272A7FA0, 0xBAFD4719, 0x0241207C, 0x10F48F92, 0xA848E8F7,
+        0x9B14583D, 0x23A83F58, 0x311D90B6, 0x89A1F7D3, 0x1476CF6A, 0xACCAA80F, 0xBE7F07E1, 0x06C36084,
+        0x5EA070D2, 0xE61C17B7, 0xF4A9B859, 0x4C15DF3C, 0xD1C2E785, 0x697E80E0, 0x7BCB2F0E, 0xC377486B,
+        0xCB0D0FA2, 0x73B168C7, 0x6104C729, 0xD9B8A04C, 0x446F98F5, 0xFCD3FF90, 0xEE66507E, 0x56DA371B,
+        0x0EB9274D, 0xB6054028, 0xA4B0EFC6, 0x1C0C88A3, 0x81DBB01A, 0x3967D77F, 0x2BD27891, 0x936E1FF4,
+        0x3B26F703, 0x839A9066, 0x912F3F88, 0x299358ED, 0xB4446054, 0x0CF80731, 0x1E4DA8DF, 0xA6F1CFBA,
+        0xFE92DFEC, 0x462EB889, 0x549B1767, 0xEC277002, 0x71F048BB, 0xC94C2FDE, 0xDBF98030, 0x6345E755,
+        0x6B3FA09C, 0xD383C7F9, 0xC1366817, 0x798A0F72, 0xE45D37CB, 0x5CE150AE, 0x4E54FF40, 0xF6E89825,
+        0xAE8B8873, 0x1637EF16, 0x048240F8, 0xBC3E279D, 0x21E91F24, 0x99557841, 0x8BE0D7AF, 0x335CB0CA,
+        0xED59B63B, 0x55E5D15E, 0x47507EB0, 0xFFEC19D5, 0x623B216C, 0xDA874609, 0xC832E9E7, 0x708E8E82,
+        0x28ED9ED4, 0x9051F9B1, 0x82E4565F, 0x3A58313A, 0xA78F0983, 0x1F336EE6, 0x0D86C108, 0xB53AA66D,
+        0xBD40E1A4, 0x05FC86C1, 0x1749292F, 0xAFF54E4A, 0x322276F3, 0x8A9E1196, 0x982BBE78, 0x2097D91D,
+        0x78F4C94B, 0xC048AE2E, 0xD2FD01C0, 0x6A4166A5, 0xF7965E1C, 0x4F2A3979, 0x5D9F9697, 0xE523F1F2,
+        0x4D6B1905, 0xF5D77E60, 0xE762D18E, 0x5FDEB6EB, 0xC2098E52, 0x7AB5E937, 0x680046D9, 0xD0BC21BC,
+        0x88DF31EA, 0x3063568F, 0x22D6F961, 0x9A6A9E04, 0x07BDA6BD, 0xBF01C1D8, 0xADB46E36, 0x15080953,
+        0x1D724E9A, 0xA5CE29FF, 0xB77B8611, 0x0FC7E174, 0x9210D9CD, 0x2AACBEA8, 0x38191146, 0x80A57623,
+        0xD8C66675, 0x607A0110, 0x72CFAEFE, 0xCA73C99B, 0x57A4F122, 0xEF189647, 0xFDAD39A9, 0x45115ECC,
+        0x764DEE06, 0xCEF18963, 0xDC44268D, 0x64F841E8, 0xF92F7951, 0x41931E34, 0x5326B1DA, 0xEB9AD6BF,
+        0xB3F9C6E9, 0x0B45A18C, 0x19F00E62, 0xA14C6907, 0x3C9B51BE, 0x842736DB, 0x96929935, 0x2E2EFE50,
+        0x2654B999, 0x9EE8DEFC, 0x8C5D7112, 0x34E11677, 0xA9362ECE, 0x118A49AB, 0x033FE645, 0xBB838120,
+        0xE3E09176, 0x5B5CF613, 0x49E959FD, 0xF1553E98, 0x6C820621, 0xD43E6144, 0xC68BCEAA, 0x7E37A9CF,
+        0xD67F4138, 0x6EC3265D, 0x7C7689B3, 0xC4CAEED6, 0x591DD66F, 0xE1A1B10A, 0xF3141EE4, 0x4BA87981,
+        0x13CB69D7, 0xAB770EB2, 0xB9C2A15C, 0x017EC639, 0x9CA9FE80, 0x241599E5, 0x36A0360B, 0x8E1C516E,
+        0x866616A7, 0x3EDA71C2, 0x2C6FDE2C, 0x94D3B949, 0x090481F0, 0xB1B8E695, 0xA30D497B, 0x1BB12E1E,
+        0x43D23E48, 0xFB6E592D, 0xE9DBF6C3, 0x516791A6, 0xCCB0A91F, 0x740CCE7A, 0x66B96194, 0xDE0506F1,
+    },
+    {
+        0x00000000, 0x3D6029B0, 0x7AC05360, 0x47A07AD0, 0xF580A6C0, 0xC8E08F70, 0x8F40F5A0, 0xB220DC10,
+        0x30704BC1, 0x0D106271, 0x4AB018A1, 0x77D03111, 0xC5F0ED01, 0xF890C4B1, 0xBF30BE61, 0x825097D1,
+        0x60E09782, 0x5D80BE32, 0x1A20C4E2, 0x2740ED52, 0x95603142, 0xA80018F2, 0xEFA06222, 0xD2C04B92,
+        0x5090DC43, 0x6DF0F5F3, 0x2A508F23, 0x1730A693, 0xA5107A83, 0x98705333, 0xDFD029E3, 0xE2B00053,
+        0xC1C12F04, 0xFCA106B4, 0xBB017C64, 0x866155D4, 0x344189C4, 0x0921A074, 0x4E81DAA4, 0x73E1F314,
+        0xF1B164C5, 0xCCD14D75, 0x8B7137A5, 0xB6111E15, 0x0431C205, 0x3951EBB5, 0x7EF19165, 0x4391B8D5,
+        0xA121B886, 0x9C419136, 0xDBE1EBE6, 0xE681C256, 0x54A11E46, 0x69C137F6, 0x2E614D26, 0x13016496,
+        0x9151F347, 0xAC31DAF7, 0xEB91A027, 0xD6F18997, 0x64D15587, 0x59B17C37, 0x1E1106E7, 0x23712F57,
+        0x58F35849, 0x659371F9, 0x22330B29, 0x1F532299, 0xAD73FE89, 0x9013D739, 0xD7B3ADE9, 0xEAD38459,
+        0x68831388, 0x55E33A38, 0x124340E8, 0x2F236958, 0x9D03B548, 0xA0639CF8, 0xE7C3E628, 0xDAA3CF98,
+        0x3813CFCB, 0x0573E67B, 0x42D39CAB, 0x7FB3B51B, 0xCD93690B, 0xF0F340BB, 0xB7533A6B, 0x8A3313DB,
+        0x0863840A, 0x3503ADBA, 0x72A3D76A, 0x4FC3FEDA, 0xFDE322CA, 0xC0830B7A, 0x872371AA, 0xBA43581A,
+        0x9932774D, 0xA4525EFD, 0xE3F2242D, 0xDE920D9D, 0x6CB2D18D, 0x51D2F83D, 0x167282ED, 0x2B12AB5D,
+        0xA9423C8C, 0x9422153C, 0xD3826FEC, 0xEEE2465C, 0x5CC29A4C, 0x61A2B3FC, 0x2602C92C, 0x1B62E09C,
+        0xF9D2E0CF, 0xC4B2C97F, 0x8312B3AF, 0xBE729A1F, 0x0C52460F, 0x31326FBF, 0x7692156F, 0x4BF23CDF,
+        0xC9A2AB0E, 0xF4C282BE, 0xB362F86E, 0x8E02D1DE, 0x3C220DCE, 0x0142247E, 0x46E25EAE, 0x7B82771E,
+        0xB1E6B092, 0x8C869922, 0xCB26E3F2, 0xF646CA42, 0x44661652, 0x79063FE2, 0x3EA64532, 0x03C66C82,
+        0x8196FB53, 0xBCF6D2E3, 0xFB56A833, 0xC6368183, 0x74165D93, 0x49767423, 0x0ED60EF3, 0x33B62743,
+        0xD1062710, 0xEC660EA0, 0xABC67470, 0x96A65DC0, 0x248681D0, 0x19E6A860, 0x5E46D2B0, 0x6326FB00,
+        0xE1766CD1, 0xDC164561, 0x9BB63FB1, 0xA6D61601, 0x14F6CA11, 0x2996E3A1, 0x6E369971, 0x5356B0C1,
+        0x70279F96, 0x4D47B626, 0x0AE7CCF6, 0x3787E546, 0x85A73956, 0xB8C710E6, 0xFF676A36, 0xC2074386,
+        0x4057D457, 0x7D37FDE7, 0x3A978737, 0x07F7AE87, 0xB5D77297, 0x88B75B27, 0xCF1721F7, 0xF2770847,
+        0x10C70814, 0x2DA721A4, 0x6A075B74, 0x576772C4, 0xE547AED4, 0xD8278764, 0x9F87FDB4, 0xA2E7D404,
+        0x20B743D5, 0x1DD76A65, 0x5A7710B5, 0x67173905, 0xD537E515, 0xE857CCA5, 0xAFF7B675, 0x92979FC5,
+        0xE915E8DB, 0xD475C16B, 0x93D5BBBB, 0xAEB5920B, 0x1C954E1B, 0x21F567AB, 0x66551D7B, 0x5B3534CB,
+        0xD965A31A, 0xE4058AAA, 0xA3A5F07A, 0x9EC5D9CA, 0x2CE505DA, 0x11852C6A, 0x562556BA, 0x6B457F0A,
+        0x89F57F59, 0xB49556E9, 0xF3352C39, 0xCE550589, 0x7C75D999, 0x4115F029, 0x06B58AF9, 0x3BD5A349,
+        0xB9853498, 0x84E51D28, 0xC34567F8, 0xFE254E48, 0x4C059258, 0x7165BBE8, 0x36C5C138, 0x0BA5E888,
+        0x28D4C7DF, 0x15B4EE6F, 0x521494BF, 0x6F74BD0F, 0xDD54611F, 0xE03448AF, 0xA794327F, 0x9AF41BCF,
+        0x18A48C1E, 0x25C4A5AE, 0x6264DF7E, 0x5F04F6CE, 0xED242ADE, 0xD044036E, 0x97E479BE, 0xAA84500E,
+        0x4834505D, 0x755479ED, 0x32F4033D, 0x0F942A8D, 0xBDB4F69D, 0x80D4DF2D, 0xC774A5FD, 0xFA148C4D,
+        0x78441B9C, 0x4524322C, 0x028448FC, 0x3FE4614C, 0x8DC4BD5C, 0xB0A494EC, 0xF704EE3C, 0xCA64C78C,
+    },
+    {
+        0x00000000, 0xCB5CD3A5, 0x4DC8A10B, 0x869472AE, 0x9B914216, 0x50CD91B3, 0xD659E31D, 0x1D0530B8,
+        0xEC53826D, 0x270F51C8, 0xA19B2366, 0x6AC7F0C3, 0x77C2C07B, 0xBC9E13DE, 0x3A0A6170, 0xF156B2D5,
+        0x03D6029B, 0xC88AD13E, 0x4E1EA390, 0x85427035, 0x9847408D, 0x531B9328, 0xD58FE186, 0x1ED33223,
+        0xEF8580F6, 0x24D95353, 0xA24D21FD, 0x6911F258, 0x7414C2E0, 0xBF481145, 0x39DC63EB, 0xF280B04E,
+        0x07AC0536, 0xCCF0D693, 0x4A64A43D, 0x81387798, 0x9C3D4720, 0x57619485, 0xD1F5E62B, 0x1AA9358E,
+        0xEBFF875B, 0x20A354FE, 0xA6372650, 0x6D6BF5F5, 0x706EC54D, 0xBB3216E8, 0x3DA66446, 0xF6FAB7E3,
+        0x047A07AD, 0xCF26D408, 0x49B2A6A6, 0x82EE7503, 0x9FEB45BB, 0x54B7961E, 0xD223E4B0, 0x197F3715,
+        0xE82985C0, 0x23755665, 0xA5E124CB, 0x6EBDF76E, 0x73B8C7D6, 0xB8E41473, 0x3E7066DD, 0xF52CB578,
+        0x0F580A6C, 0xC404D9C9, 0x4290AB67, 0x89CC78C2, 0x94C9487A, 0x5F959BDF, 0xD901E971, 0x125D3AD4,
+        0xE30B8801, 0x28575BA4, 0xAEC3290A, 0x659FFAAF, 0x789ACA17, 0xB3C619B2, 0x35526B1C, 0xFE0EB8B9,
+        0x0C8E08F7, 0xC7D2DB52, 0x4146A9FC, 0x8A1A7A59, 0x971F4AE1, 0x5C439944, 0xDAD7EBEA, 0x118B384F,
+        0xE0DD8A9A, 0x2B81593F, 0xAD152B91, 0x6649F834, 0x7B4CC88C, 0xB0101B29, 0x36846987, 0xFDD8BA22,
+        0x08F40F5A, 0xC3A8DCFF, 0x453CAE51, 0x8E607DF4, 0x93654D4C, 0x58399EE9, 0xDEADEC47, 0x15F13FE2,
+        0xE4A78D37, 0x2FFB5E92, 0xA96F2C3C, 0x6233FF99, 0x7F36CF21, 0xB46A1C84, 0x32FE6E2A, 0xF9A2BD8F,
+        0x0B220DC1, 0xC07EDE64, 0x46EAACCA, 0x8DB67F6F, 0x90B34FD7, 0x5BEF9C72, 0xDD7BEEDC, 0x16273D79,
+        0xE7718FAC, 0x2C2D5C09, 0xAAB92EA7, 0x61E5FD02, 0x7CE0CDBA, 0xB7BC1E1F, 0x31286CB1, 0xFA74BF14,
+        0x1EB014D8, 0xD5ECC77D, 0x5378B5D3, 0x98246676, 0x852156CE, 0x4E7D856B, 0xC8E9F7C5, 0x03B52460,
+        0xF2E396B5, 0x39BF4510, 0xBF2B37BE, 0x7477E41B, 0x6972D4A3, 0xA22E0706, 0x24BA75A8, 0xEFE6A60D,
+        0x1D661643, 0xD63AC5E6, 0x50AEB748, 0x9BF264ED, 0x86F75455, 0x4DAB87F0, 0xCB3FF55E, 0x006326FB,
+        0xF135942E, 0x3A69478B, 0xBCFD3525, 0x77A1E680, 0x6AA4D638, 0xA1F8059D, 0x276C7733, 0xEC30A496,
+        0x191C11EE, 0xD240C24B, 0x54D4B0E5, 0x9F886340, 0x828D53F8, 0x49D1805D, 0xCF45F2F3, 0x04192156,
+        0xF54F9383, 0x3E134026, 0xB8873288, 0x73DBE12D, 0x6EDED195, 0xA5820230, 0x2316709E, 0xE84AA33B,
+        0x1ACA1375, 0xD196C0D0, 0x5702B27E, 0x9C5E61DB, 0x815B5163, 0x4A0782C6, 0xCC93F068, 0x07CF23CD,
+        0xF6999118, 0x3DC542BD, 0xBB513013, 0x700DE3B6, 0x6D08D30E, 0xA65400AB, 0x20C07205, 0xEB9CA1A0,
+        0x11E81EB4, 0xDAB4CD11, 0x5C20BFBF, 0x977C6C1A, 0x8A795CA2, 0x41258F07, 0xC7B1FDA9, 0x0CED2E0C,
+        0xFDBB9CD9, 0x36E74F7C, 0xB0733DD2, 0x7B2FEE77, 0x662ADECF, 0xAD760D6A, 0x2BE27FC4, 0xE0BEAC61,
+        0x123E1C2F, 0xD962CF8A, 0x5FF6BD24, 0x94AA6E81, 0x89AF5E39, 0x42F38D9C, 0xC467FF32, 0x0F3B2C97,
+        0xFE6D9E42, 0x35314DE7, 0xB3A53F49, 0x78F9ECEC, 0x65FCDC54, 0xAEA00FF1, 0x28347D5F, 0xE368AEFA,
+        0x16441B82, 0xDD18C827, 0x5B8CBA89, 0x90D0692C, 0x8DD55994, 0x46898A31, 0xC01DF89F, 0x0B412B3A,
+        0xFA1799EF, 0x314B4A4A, 0xB7DF38E4, 0x7C83EB41, 0x6186DBF9, 0xAADA085C, 0x2C4E7AF2, 0xE712A957,
+        0x15921919, 0xDECECABC, 0x585AB812, 0x93066BB7, 0x8E035B0F, 0x455F88AA, 0xC3CBFA04, 0x089729A1,
+        0xF9C19B74, 0x329D48D1, 0xB4093A7F, 0x7F55E9DA, 0x6250D962, 0xA90C0AC7, 0x2F987869, 0xE4C4ABCC,
+    },
+    {
+        0x00000000, 0xA6770BB4, 0x979F1129, 0x31E81A9D, 0xF44F2413, 0x52382FA7, 0x63D0353A, 0xC5A73E8E,
+        0x33EF4E67, 0x959845D3, 0xA4705F4E, 0x020754FA, 0xC7A06A74, 0x61D761C0, 0x503F7B5D, 0xF64870E9,
+        0x67DE9CCE, 0xC1A9977A, 0xF0418DE7, 0x56368653, 0x9391B8DD, 0x35E6B369, 0x040EA9F4, 0xA279A240,
+        0x5431D2A9, 0xF246D91D, 0xC3AEC380, 0x65D9C834, 0xA07EF6BA, 0x0609FD0E, 0x37E1E793, 0x9196EC27,
+        0xCFBD399C, 0x69CA3228, 0x582228B5, 0xFE552301, 0x3BF21D8F, 0x9D85163B, 0xAC6D0CA6, 0x0A1A0712,
+        0xFC5277FB, 0x5A257C4F, 0x6BCD66D2, 0xCDBA6D66, 0x081D53E8, 0xAE6A585C, 0x9F8242C1, 0x39F54975,
+        0xA863A552, 0x0E14AEE6, 0x3FFCB47B, 0x998BBFCF, 0x5C2C8141, 0xFA5B8AF5, 0xCBB39068, 0x6DC49BDC,
+        0x9B8CEB35, 0x3DFBE081, 0x0C13FA1C, 0xAA64F1A8, 0x6FC3CF26, 0xC9B4C492, 0xF85CDE0F, 0x5E2BD5BB,
+        0x440B7579, 0xE27C7ECD, 0xD3946450, 0x75E36FE4, 0xB044516A, 0x16335ADE, 0x27DB4043, 0x81AC4BF7,
+        0x77E43B1E, 0xD19330AA, 0xE07B2A37, 0x460C2183, 0x83AB1F0D, 0x25DC14B9, 0x14340E24, 0xB2430590,
+        0x23D5E9B7, 0x85A2E203, 0xB44AF89E, 0x123DF32A, 0xD79ACDA4, 0x71EDC610, 0x4005DC8D, 0xE672D739,
+        0x103AA7D0, 0xB64DAC64, 0x87A5B6F9, 0x21D2BD4D, 0xE47583C3, 0x42028877, 0x73EA92EA, 0xD59D995E,
+        0x8BB64CE5, 0x2DC14751, 0x1C295DCC, 0xBA5E5678, 0x7FF968F6, 0xD98E6342, 0xE86679DF, 0x4E11726B,
+        0xB8590282, 0x1E2E0936, 0x2FC613AB, 0x89B1181F, 0x4C162691, 0xEA612D25, 0xDB8937B8, 0x7DFE3C0C,
+        0xEC68D02B, 0x4A1FDB9F, 0x7BF7C102, 0xDD80CAB6, 0x1827F438, 0xBE50FF8C, 0x8FB8E511, 0x29CFEEA5,
+        0xDF879E4C, 0x79F095F8, 0x48188F65, 0xEE6F84D1, 0x2BC8BA5F, 0x8DBFB1EB, 0xBC57AB76, 0x1A20A0C2,
+        0x8816EAF2, 0x2E61E146, 0x1F89FBDB, 0xB9FEF06F, 0x7C59CEE1, 0xDA2EC555, 0xEBC6DFC8, 0x4DB1D47C,
+        0xBBF9A495, 0x1D8EAF21, 0x2C66B5BC, 0x8A11BE08, 0x4FB68086, 0xE9C18B32, 0xD82991AF, 0x7E5E9A1B,
+        0xEFC8763C, 0x49BF7D88, 0x78576715, 0xDE206CA1, 0x1B87522F, 0xBDF0599B, 0x8C184306, 0x2A6F48B2,
+        0xDC27385B, 0x7A5033EF, 0x4BB82972, 0xEDCF22C6, 0x28681C48, 0x8E1F17FC, 0xBFF70D61, 0x198006D5,
+        0x47ABD36E, 0xE1DCD8DA, 0xD034C247, 0x7643C9F3, 0xB3E4F77D, 0x1593FCC9, 0x247BE654, 0x820CEDE0,
+        0x74449D09, 0xD23396BD, 0xE3DB8C20, 0x45AC8794, 0x800BB91A, 0x267CB2AE, 0x1794A833, 0xB1E3A387,
+        0x20754FA0, 0x86024414, 0xB7EA5E89, 0x119D553D, 0xD43A6BB3, 0x724D6007, 0x43A57A9A, 0xE5D2712E,
+        0x139A01C7, 0xB5ED0A73, 0x840510EE, 0x22721B5A, 0xE7D525D4, 0x41A22E60, 0x704A34FD, 0xD63D3F49,
+        0xCC1D9F8B, 0x6A6A943F, 0x5B828EA2, 0xFDF58516, 0x3852BB98, 0x9E25B02C, 0xAFCDAAB1, 0x09BAA105,
+        0xFFF2D1EC, 0x5985DA58, 0x686DC0C5, 0xCE1ACB71, 0x0BBDF5FF, 0xADCAFE4B, 0x9C22E4D6, 0x3A55EF62,
+        0xABC30345, 0x0DB408F1, 0x3C5C126C, 0x9A2B19D8, 0x5F8C2756, 0xF9FB2CE2, 0xC813367F, 0x6E643DCB,
+        0x982C4D22, 0x3E5B4696, 0x0FB35C0B, 0xA9C457BF, 0x6C636931, 0xCA146285, 0xFBFC7818, 0x5D8B73AC,
+        0x03A0A617, 0xA5D7ADA3, 0x943FB73E, 0x3248BC8A, 0xF7EF8204, 0x519889B0, 0x6070932D, 0xC6079899,
+        0x304FE870, 0x9638E3C4, 0xA7D0F959, 0x01A7F2ED, 0xC400CC63, 0x6277C7D7, 0x539FDD4A, 0xF5E8D6FE,
+        0x647E3AD9, 0xC209316D, 0xF3E12BF0, 0x55962044, 0x90311ECA, 0x3646157E, 0x07AE0FE3, 0xA1D90457,
+        0x579174BE, 0xF1E67F0A, 0xC00E6597, 0x66796E23, 0xA3DE50AD, 0x05A95B19, 0x34414184, 0x92364A30,
+    },
+    {
+        0x00000000, 0xCCAA009E, 0x4225077D, 0x8E8F07E3, 0x844A0EFA, 0x48E00E64, 0xC66F0987, 0x0AC50919,
+        0xD3E51BB5, 0x1F4F1B2B, 0x91C01CC8, 0x5D6A1C56, 0x57AF154F, 0x9B0515D1, 0x158A1232, 0xD92012AC,
+        0x7CBB312B, 0xB01131B5, 0x3E9E3656, 0xF23436C8, 0xF8F13FD1, 0x345B3F4F, 0xBAD438AC, 0x767E3832,
+        0xAF5E2A9E, 0x63F42A00, 0xED7B2DE3, 0x21D12D7D, 0x2B142464, 0xE7BE24FA, 0x69312319, 0xA59B2387,
+        0xF9766256, 0x35DC62C8, 0xBB53652B, 0x77F965B5, 0x7D3C6CAC, 0xB1966C32, 0x3F196BD1, 0xF3B36B4F,
+        0x2A9379E3, 0xE639797D, 0x68B67E9E, 0xA41C7E00, 0xAED97719, 0x62737787, 0xECFC7064, 0x205670FA,
+        0x85CD537D, 0x496753E3, 0xC7E85400, 0x0B42549E, 0x01875D87, 0xCD2D5D19, 0x43A25AFA, 0x8F085A64,
+        0x562848C8, 0x9A824856, 0x140D4FB5, 0xD8A74F2B, 0xD2624632, 0x1EC846AC, 0x9047414F, 0x5CED41D1,
+        0x299DC2ED, 0xE537C273, 0x6BB8C590, 0xA712C50E, 0xADD7CC17, 0x617DCC89, 0xEFF2CB6A, 0x2358CBF4,
+        0xFA78D958, 0x36D2D9C6, 0xB85DDE25, 0x74F7DEBB, 0x7E32D7A2, 0xB298D73C, 0x3C17D0DF, 0xF0BDD041,
+        0x5526F3C6, 0x998CF358, 0x1703F4BB, 0xDBA9F425, 0xD16CFD3C, 0x1DC6FDA2, 0x9349FA41, 0x5FE3FADF,
+        0x86C3E873, 0x4A69E8ED, 0xC4E6EF0E, 0x084CEF90, 0x0289E689, 0xCE23E617, 0x40ACE1F4, 0x8C06E16A,
+        0xD0EBA0BB, 0x1C41A025, 0x92CEA7C6, 0x5E64A758, 0x54A1AE41, 0x980BAEDF, 0x1684A93C, 0xDA2EA9A2,
+        0x030EBB0E, 0xCFA4BB90, 0x412BBC73, 0x8D81BCED, 0x8744B5F4, 0x4BEEB56A, 0xC561B289, 0x09CBB217,
+        0xAC509190, 0x60FA910E, 0xEE7596ED, 0x22DF9673, 0x281A9F6A, 0xE4B09FF4, 0x6A3F9817, 0xA6959889,
+        0x7FB58A25, 0xB31F8ABB, 0x3D908D58, 0xF13A8DC6, 0xFBFF84DF, 0x37558441, 0xB9DA83A2, 0x7570833C,
+        0x533B85DA, 0x9F918544, 0x111E82A7, 0xDDB48239, 0xD7718B20, 0x1BDB8BBE, 0x95548C5D, 0x59FE8CC3,
+        0x80DE9E6F, 0x4C749EF1, 0xC2FB9912, 0x0E51998C, 0x04949095, 0xC83E900B, 0x46B197E8, 0x8A1B9776,
+        0x2F80B4F1, 0xE32AB46F, 0x6DA5B38C, 0xA10FB312, 0xABCABA0B, 0x6760BA95, 0xE9EFBD76, 0x2545BDE8,
+        0xFC65AF44, 0x30CFAFDA, 0xBE40A839, 0x72EAA8A7, 0x782FA1BE, 0xB485A120, 0x3A0AA6C3, 0xF6A0A65D,
+        0xAA4DE78C, 0x66E7E712, 0xE868E0F1, 0x24C2E06F, 0x2E07E976, 0xE2ADE9E8, 0x6C22EE0B, 0xA088EE95,
+        0x79A8FC39, 0xB502FCA7, 0x3B8DFB44, 0xF727FBDA, 0xFDE2F2C3, 0x3148F25D, 0xBFC7F5BE, 0x736DF520,
+        0xD6F6D6A7, 0x1A5CD639, 0x94D3D1DA, 0x5879D144, 0x52BCD85D, 0x9E16D8C3, 0x1099DF20, 0xDC33DFBE,
+        0x0513CD12, 0xC9B9CD8C, 0x4736CA6F, 0x8B9CCAF1, 0x8159C3E8, 0x4DF3C376, 0xC37CC495, 0x0FD6C40B,
+        0x7AA64737, 0xB60C47A9, 0x3883404A, 0xF42940D4, 0xFEEC49CD, 0x32464953, 0xBCC94EB0, 0x70634E2E,
+        0xA9435C82, 0x65E95C1C, 0xEB665BFF, 0x27CC5B61, 0x2D095278, 0xE1A352E6, 0x6F2C5505, 0xA386559B,
+        0x061D761C, 0xCAB77682, 0x44387161, 0x889271FF, 0x825778E6, 0x4EFD7878, 0xC0727F9B, 0x0CD87F05,
+        0xD5F86DA9, 0x19526D37, 0x97DD6AD4, 0x5B776A4A, 0x51B26353, 0x9D1863CD, 0x1397642E, 0xDF3D64B0,
+        0x83D02561, 0x4F7A25FF, 0xC1F5221C, 0x0D5F2282, 0x079A2B9B, 0xCB302B05, 0x45BF2CE6, 0x89152C78,
+        0x50353ED4, 0x9C9F3E4A, 0x121039A9, 0xDEBA3937, 0xD47F302E, 0x18D530B0, 0x965A3753, 0x5AF037CD,
+        0xFF6B144A, 0x33C114D4, 0xBD4E1337, 0x71E413A9, 0x7B211AB0, 0xB78B1A2E, 0x39041DCD, 0xF5AE1D53,
+        0x2C8E0FFF, 0xE0240F61, 0x6EAB0882, 0xA201081C, 0xA8C40105, 0x646E019B, 0xEAE10678, 0x264B06E6,
+    },
+};
+
+DSTATIC inline uint16_t get_crc16(const uint8_t* data, size_t size, uint16_t crc)
 {
+    while (size >= 8) {
+        crc = crc16_table[7][(crc >> 8) ^ data[0]] ^ crc16_table[6][(crc & 0xFF) ^ data[1]] ^
+              crc16_table[5][data[2]]              ^ crc16_table[4][data[3]] ^
+              crc16_table[3][data[4]]              ^ crc16_table[2][data[5]] ^
+              crc16_table[1][data[6]]              ^ crc16_table[0][data[7]];
+        data += 8;
+        size -= 8;
+    }
     for (size_t i = 0; i < size; i++) {
-        crc = crc8_table[crc ^ data[i]];
+        crc = (crc << 8) ^ crc16_table[0][(crc >> 8) ^ data[i]];
     }
     return crc;
 }
 
+DSTATIC inline uint32_t get_crc32(const uint8_t* data, size_t size, uint32_t crc)
+{
+    crc = ~crc;
+    while (size >= 8) {
+        uint32_t word = crc ^ (data[0] | (uint32_t)data[1] << 8 |
+                               (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+        crc = crc32_table[7][word & 0xFF]         ^ crc32_table[6][(word >> 8) & 0xFF] ^
+              crc32_table[5][(word >> 16) & 0xFF] ^ crc32_table[4][word >> 24] ^
+              crc32_table[3][data[4]]             ^ crc32_table[2][data[5]] ^
+              crc32_table[1][data[6]]             ^ crc32_table[0][data[7]];
+        data += 8;
+        size -= 8;
+    }
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc >> 8) ^ crc32_table[0][(crc ^ data[i]) & 0xFF];
+    }
+    return ~crc;
+}
+
+#ifdef CWAKE_SIMD_X86
+// best kernel of cpu, detected once by cwake_init (or by first use). Every
+// thread stores the same value, so relaxed access is enough.
+static int cpu_kernel = -1;
+
+static int detect_kernel(void)
+{
+    __builtin_cpu_init();
+    int kernel = __builtin_cpu_supports("avx2") ? KERNEL_AVX2 : KERNEL_SSE2;
+    __atomic_store_n(&cpu_kernel, kernel, __ATOMIC_RELAXED);
+    return kernel;
+}
+#endif
+
+static inline int kernel_level(void)
+{
+    int kernel = KERNEL_SCALAR;
+#ifdef CWAKE_SIMD_X86
+    kernel = __atomic_load_n(&cpu_kernel, __ATOMIC_RELAXED);
+    if (kernel < 0) kernel = detect_kernel();
+#endif
+#ifdef CWAKE_TEST
+    if (kernel > kernel_limit) kernel = kernel_limit;
+#endif
+    return kernel;
+}
+
 // BYTESTUFFING
-DSTATIC size_t stuff(const uint8_t* src, uint8_t src_len, uint8_t* dst) {
+DSTATIC size_t stuff_scalar(const uint8_t* src, size_t src_len, uint8_t* dst) {
     size_t dst_len = 0;
 
-    if(src_len > 0) dst[dst_len++] = src[0];
-
-    for (uint8_t i = 1; i < src_len; i++) {
+    for (size_t i = 0; i < src_len; i++) {
         uint8_t current_byte = src[i];
 
         if (current_byte == FEND) {
@@ -164,7 +958,126 @@ DSTATIC size_t stuff(const uint8_t* src, uint8_t src_len, uint8_t* dst) {
     return dst_len;
 }
 
-DSTATIC size_t destuff(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_max_len) {
+#ifdef CWAKE_SIMD_X86
+// stuff 'size' bytes of block with known escape positions 'mask'
+static inline uint8_t* stuff_masked(const uint8_t* src, size_t size,
+                                    uint32_t mask, uint8_t* dst)
+{
+    size_t pos = 0;
+    while (mask) {
+        size_t esc = __builtin_ctz(mask);
+        memcpy(dst, src + pos, esc - pos);
+        dst += esc - pos;
+        *dst++ = FESC;
+        *dst++ = (src[esc] == FEND) ? TFEND : TFESC;
+        pos = esc + 1;
+        mask &= mask - 1;
+    }
+    memcpy(dst, src + pos, size - pos);
+    return dst + size - pos;
+}
+
+static size_t stuff_sse2(const uint8_t* src, size_t src_len, uint8_t* dst) {
+    const __m128i fend  = _mm_set1_epi8((char)FEND);
+    const __m128i fesc  = _mm_set1_epi8((char)FESC);
+    const __m128i tfend = _mm_set1_epi8((char)TFEND);
+    const __m128i tfesc = _mm_set1_epi8((char)TFESC);
+    uint8_t* out = dst;
+    size_t i = 0;
+
+    for (; i + 16 <= src_len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i is_fend = _mm_cmpeq_epi8(v, fend);
+        __m128i is_esc = _mm_or_si128(is_fend, _mm_cmpeq_epi8(v, fesc));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(is_esc);
+
+        if (mask == 0) {            // escape-free run: bulk copy
+            _mm_storeu_si128((__m128i*)out, v);
+            out += 16;
+        } else if (mask == 0xFFFF) { // escape-only run: interleave FESC/Tx
+            __m128i t = _mm_or_si128(_mm_and_si128(is_fend, tfend),
+                                     _mm_andnot_si128(is_fend, tfesc));
+            _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(fesc, t));
+            _mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(fesc, t));
+            out += 32;
+        } else {
+            out = stuff_masked(src + i, 16, mask, out);
+        }
+    }
+
+    return (out - dst) + stuff_scalar(src + i, src_len - i, out);
+}
+
+__attribute__((target("avx2")))
+static size_t stuff_avx2(const uint8_t* src, size_t src_len, uint8_t* dst) {
+    const __m256i fend  = _mm256_set1_epi8((char)FEND);
+    const __m256i fesc  = _mm256_set1_epi8((char)FESC);
+    const __m256i tfend = _mm256_set1_epi8((char)TFEND);
+    const __m256i tfesc = _mm256_set1_epi8((char)TFESC);
+    uint8_t* out = dst;
+    size_t i = 0;
+
+    for (; i + 32 <= src_len; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i is_fend = _mm256_cmpeq_epi8(v, fend);
+        __m256i is_esc = _mm256_or_si256(is_fend, _mm256_cmpeq_epi8(v, fesc));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(is_esc);
+
+        if (mask == 0) {
+            _mm256_storeu_si256((__m256i*)out, v);
+            out += 32;
+        } else if (mask == 0xFFFFFFFF) {
+            __m256i t = _mm256_blendv_epi8(tfesc, tfend, is_fend);
+            // unpack works per 128-bit lane, restore byte order with permute
+            __m256i lo = _mm256_unpacklo_epi8(fesc, t);
+            __m256i hi = _mm256_unpackhi_epi8(fesc, t);
+            _mm256_storeu_si256((__m256i*)out,
+                                _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i*)(out + 32),
+                                _mm256_permute2x128_si256(lo, hi, 0x31));
+            out += 64;
+        } else {
+            out = stuff_masked(src + i, 32, mask, out);
+        }
+    }
+
+    return (out - dst) + stuff_scalar(src + i, src_len - i, out);
+}
+#endif
+
+static inline size_t stuff_kernel(const uint8_t* src, size_t src_len, uint8_t* dst)
+{
+#ifdef CWAKE_SIMD_X86
+    int kernel = kernel_level();
+    if (kernel == KERNEL_AVX2) return stuff_avx2(src, src_len, dst);
+    if (kernel == KERNEL_SSE2) return stuff_sse2(src, src_len, dst);
+#endif
+    return stuff_scalar(src, src_len, dst);
+}
+
+DSTATIC size_t stuff(const uint8_t* src, uint8_t src_len, uint8_t* dst) {
+    if (src_len == 0) return 0;
+
+    dst[0] = src[0]; // preamble is not stuffed
+    return 1 + stuff_kernel(src + 1, src_len - 1, dst + 1);
+}
+
+// stuff src to dst and update crc of src in the same pass over the data,
+// blockwise so every block is checksummed while it is still in L1
+DSTATIC size_t stuff_crc8(const uint8_t* src, size_t src_len, uint8_t* dst, uint8_t* crc)
+{
+    const size_t block_size = 64;
+    size_t dst_len = 0;
+
+    for (size_t i = 0; i < src_len; i += block_size) {
+        size_t block = src_len - i < block_size ? src_len - i : block_size;
+        *crc = get_crc8(src + i, block, *crc);
+        dst_len += stuff_kernel(src + i, block, dst + dst_len);
+    }
+    return dst_len;
+}
+
+DSTATIC size_t destuff_scalar(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_max_len) {
     size_t dst_len = 0;
 
     for (size_t i = 0; i < src_len; i++) {
@@ -186,190 +1099,1408 @@ DSTATIC size_t destuff(const uint8_t* src, size_t src_len, uint8_t* dst, size_t
     return dst_len;
 }
 
-// ========================================================== Public functional
-cwake_error cwake_init(cwake_platform* platform)
+#ifdef CWAKE_SIMD_X86
+// Vector kernels copy escape-free blocks while dst has room for them,
+// decode blocks with escapes bytewise and leave the tail (and exact overflow
+// detection) to the scalar kernel.
+static inline int destuff_block(const uint8_t* src, size_t src_len,
+                                size_t* i, size_t end,
+                                uint8_t* dst, size_t* dst_len)
 {
-    generate_crc8_table(CRC8_POLYNOMIAL);
-    reset_buffer_rxenc(platform);
-    reset_buffer_rxdec(platform);
-    platform->service.uncomplete_fesc_is_reserved = 0;
-    stop_timeout_timer(platform);
+    while (*i < end) {
+        uint8_t current_byte = src[(*i)++];
+        if (current_byte == FESC) {
+            if (*i >= src_len) return 0;
+            uint8_t next_byte = src[(*i)++];
 
-    return CWAKE_ERROR_NONE;
+            if      (next_byte == TFEND) current_byte = FEND;
+            else if (next_byte == TFESC) current_byte = FESC;
+            else    return 0;
+        }
+        dst[(*dst_len)++] = current_byte;
+    }
+    return 1;
 }
 
-cwake_error cwake_poll(cwake_platform* platform)
+// Non-empty valid input never destuffs to 0 bytes, so 0 from it is an error.
+static inline size_t destuff_tail(const uint8_t* src, size_t src_len, size_t i,
+                                  uint8_t* dst, size_t dst_max_len, size_t dst_len)
 {
-    struct cwake_service* ps = &platform->service;
+    if (i >= src_len) return dst_len;
+    size_t tail = destuff_scalar(src + i, src_len - i,
+                                 dst + dst_len, dst_max_len - dst_len);
+    return tail ? dst_len + tail : 0;
+}
 
-    // ==== RECEIVING ====
-    // read external rx buffer if internal rxenc buffer is empty
-    if( is_empty_buffer_rxenc(platform) ) {//rxenc buffer is empty
-        if ( is_timeout(platform) ) {
-            reset_buffer_rxdec(platform);
-            return CWAKE_ERROR_TIMEOUT;
-        }
+static size_t destuff_sse2(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_max_len) {
+    const __m128i fesc = _mm_set1_epi8((char)FESC);
+    size_t dst_len = 0;
+    size_t i = 0;
 
-        uint32_t received = platform->read(
-                    ps->buffer_rxenc_dend + ps->uncomplete_fesc_is_reserved,
-                    WORK_BUFFER_SIZE*2
-                    );
+    while (i + 16 <= src_len && dst_len + 16 <= dst_max_len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, fesc));
 
-        if (received){
-            DEBUG_PRINT("Rx: %s", format_hex_ascii(platform->service.buffer_rxenc_dend + ps->uncomplete_fesc_is_reserved, received));
-            if (ps->uncomplete_fesc_is_reserved) *ps->buffer_rxenc_dend = FESC;
-            ps->buffer_rxenc_dend += received + ps->uncomplete_fesc_is_reserved;
-            stop_timeout_timer(platform);
+        if (mask == 0) {
+            _mm_storeu_si128((__m128i*)(dst + dst_len), v);
+            i += 16;
+            dst_len += 16;
+        } else if (!destuff_block(src, src_len, &i, i + 16, dst, &dst_len)) {
+            return 0;
         }
-        else return CWAKE_ERROR_NONE;
+    }
 
+    return destuff_tail(src, src_len, i, dst, dst_max_len, dst_len);
+}
 
-        //incomplete escape sequence skip and reservation
-        if(*(ps->buffer_rxenc_dend-1) == FESC ) {
-            ps->buffer_rxenc_dend -= 1;
-            ps->uncomplete_fesc_is_reserved = 1;
-        }
-        else {
-            ps->uncomplete_fesc_is_reserved = 0;
+__attribute__((target("avx2")))
+static size_t destuff_avx2(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_max_len) {
+    const __m256i fesc = _mm256_set1_epi8((char)FESC);
+    size_t dst_len = 0;
+    size_t i = 0;
+
+    while (i + 32 <= src_len && dst_len + 32 <= dst_max_len) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, fesc));
+
+        if (mask == 0) {
+            _mm256_storeu_si256((__m256i*)(dst + dst_len), v);
+            i += 32;
+            dst_len += 32;
+        } else if (!destuff_block(src, src_len, &i, i + 32, dst, &dst_len)) {
+            return 0;
         }
     }
 
-    // ==== FRAMING ====
-    uint8_t* buffer_rxenc_fstart = ps->buffer_rxenc_dstart;//frame start
-    uint8_t* buffer_rxenc_fend = 0;  //frame end
+    return destuff_tail(src, src_len, i, dst, dst_max_len, dst_len);
+}
+#endif
+
+static inline size_t destuff_kernel(const uint8_t* src, size_t src_len,
+                                    uint8_t* dst, size_t dst_max_len)
+{
+#ifdef CWAKE_SIMD_X86
+    int kernel = kernel_level();
+    if (kernel == KERNEL_AVX2) return destuff_avx2(src, src_len, dst, dst_max_len);
+    if (kernel == KERNEL_SSE2) return destuff_sse2(src, src_len, dst, dst_max_len);
+#endif
+    return destuff_scalar(src, src_len, dst, dst_max_len);
+}
 
+#ifdef CWAKE_TEST
+// destuff without crc, receiver uses destuff_crc8 (tests and benchmarks)
+DSTATIC size_t destuff(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_max_len) {
+    return destuff_kernel(src, src_len, dst, dst_max_len);
+}
+#endif
 
-    //skip first bytes if preamble (search msg frame start)
-    while(*buffer_rxenc_fstart == PREAMBLE) buffer_rxenc_fstart += 1;
+// destuff src to dst and update crc of decoded data in the same pass,
+// blockwise so every decoded block is checksummed while it is still in L1
+DSTATIC size_t destuff_crc8(const uint8_t* src, size_t src_len,
+                            uint8_t* dst, size_t dst_max_len, uint8_t* crc)
+{
+    const size_t block_size = 64;
+    size_t dst_len = 0;
 
-    buffer_rxenc_fend = buffer_rxenc_fstart;
+    for (size_t i = 0; i < src_len; ) {
+        size_t block = src_len - i < block_size ? src_len - i : block_size;
+        // keep escape sequence in one block
+        if (src[i + block - 1] == FESC && i + block < src_len) block += 1;
 
-    //search msg frame end (next preamble or global head)
-    while(*buffer_rxenc_fend != PREAMBLE &&
-           buffer_rxenc_fend < ps->buffer_rxenc_dend){
-        buffer_rxenc_fend += 1;
+        size_t decoded = destuff_kernel(src + i, block,
+                                        dst + dst_len, dst_max_len - dst_len);
+        if (decoded == 0) return 0;
+        *crc = get_crc8(dst + dst_len, decoded, *crc);
+        dst_len += decoded;
+        i += block;
     }
+    return dst_len;
+}
 
-    ps->buffer_rxenc_dstart = buffer_rxenc_fend;
+// FRAMING
+// FEND positions of received data are collected into a bitmap when the data
+// is read (bit N of map is set when buf[N] == FEND), frames are then found
+// with word operations instead of rescanning bytes. Map covers buffer_rx.
 
-    //check for first byte in frame is preamble
-    if(ps->buffer_rxdec_dend == ps->buffer_rxdec &&
-            (*(buffer_rxenc_fstart-1) != PREAMBLE)
-        ) {
-        return CWAKE_ERROR_INVALID_DATA;
+static inline unsigned ctz64(uint64_t word)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(word);
+#else
+    unsigned n = 0;
+    while (!(word & 1)) { word >>= 1; n++; }
+    return n;
+#endif
+}
+
+static inline void clear_fend_map(uint64_t* map, size_t pos, size_t size)
+{
+    while (size) {
+        size_t bit = pos % 64;
+        size_t bits = 64 - bit < size ? 64 - bit : size;
+        uint64_t mask = bits == 64 ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1) << bit;
+        map[pos / 64] &= ~mask;
+        pos += bits;
+        size -= bits;
     }
+}
 
-    // ==== DESTUFFING ====
-    uint32_t frame_size = buffer_rxenc_fend - buffer_rxenc_fstart;
-    uint32_t rxdec_buffer_size = 256 - (ps->buffer_rxdec_dend - ps->buffer_rxdec);
+// mark buf[pos, pos + size) in map
+DSTATIC void scan_fend_scalar(const uint8_t* buf, size_t pos, size_t size, uint64_t* map)
+{
+    const uint8_t* cur = buf + pos;
+    const uint8_t* end = buf + pos + size;
 
-    uint8_t destuffed = destuff(buffer_rxenc_fstart, frame_size,
-                                ps->buffer_rxdec_dend, rxdec_buffer_size
-                                );
-    if (destuffed == 0) {
-        return CWAKE_ERROR_INVALID_DATA;
+    clear_fend_map(map, pos, size);
+    while ((cur = memchr(cur, FEND, end - cur)) != NULL) {
+        size_t offset = cur - buf;
+        map[offset / 64] |= (uint64_t)1 << (offset % 64);
+        cur += 1;
     }
-    ps->buffer_rxdec_dend += destuffed;
+}
 
-    // ==== VALIDATING ====
-    uint32_t buffer_rxdec_stored = ps->buffer_rxdec_dend - ps->buffer_rxdec;
-    //check complete header
-    if ( buffer_rxdec_stored < HEADER_SIZE ) {
-        if (is_empty_buffer_rxenc(platform)) {
-            start_timeout_timer(platform);
-            return CWAKE_ERROR_NONE;
-        }
-        else {
-            reset_buffer_rxdec(platform);
-            return CWAKE_ERROR_INVALID_DATA;
-        }
+#ifdef CWAKE_SIMD_X86
+static inline void set_fend_mask(uint64_t* map, size_t pos, uint64_t mask)
+{
+    size_t bit = pos % 64;
+    map[pos / 64] |= mask << bit;
+    if (bit && (mask >> (64 - bit))) map[pos / 64 + 1] |= mask >> (64 - bit);
+}
+
+static void scan_fend_sse2(const uint8_t* buf, size_t pos, size_t size, uint64_t* map)
+{
+    const __m128i fend = _mm_set1_epi8((char)FEND);
+    size_t i = 0;
+
+    clear_fend_map(map, pos, size);
+    for (; i + 16 <= size; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(buf + pos + i));
+        uint64_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, fend));
+        if (mask) set_fend_mask(map, pos + i, mask);
     }
-    //check correct size code
-    if (ps->buffer_rxdec[SIZE_POS] > (WORK_BUFFER_SIZE - PREAMBLE_SIZE - HEADER_SIZE - CRC_SIZE) ) {
-        reset_buffer_rxdec(platform);
-        return CWAKE_ERROR_INVALID_DATA;
+    for (; i < size; i++) {
+        if (buf[pos + i] == FEND) set_fend_mask(map, pos + i, 1);
     }
+}
 
-    //check complete request
-    if ( buffer_rxdec_stored < (ps->buffer_rxdec[SIZE_POS] + HEADER_SIZE + CRC_SIZE) ){
-        if (is_empty_buffer_rxenc(platform)) {
-            start_timeout_timer(platform);
-            return CWAKE_ERROR_NONE;
-        }
-        else {
-            reset_buffer_rxdec(platform);
-            return CWAKE_ERROR_INVALID_DATA;
+__attribute__((target("avx2")))
+static void scan_fend_avx2(const uint8_t* buf, size_t pos, size_t size, uint64_t* map)
+{
+    const __m256i fend = _mm256_set1_epi8((char)FEND);
+    size_t i = 0;
+
+    clear_fend_map(map, pos, size);
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(buf + pos + i));
+        uint64_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, fend));
+        if (mask) set_fend_mask(map, pos + i, mask);
+    }
+    for (; i < size; i++) {
+        if (buf[pos + i] == FEND) set_fend_mask(map, pos + i, 1);
+    }
+}
+#endif
+
+DSTATIC void scan_fend(const uint8_t* buf, size_t pos, size_t size, uint64_t* map)
+{
+#ifdef CWAKE_SIMD_X86
+    int kernel = kernel_level();
+    if (kernel == KERNEL_AVX2) { scan_fend_avx2(buf, pos, size, map); return; }
+    if (kernel == KERNEL_SSE2) { scan_fend_sse2(buf, pos, size, map); return; }
+#endif
+    scan_fend_scalar(buf, pos, size, map);
+}
+
+static inline int is_fend_at(const uint64_t* map, size_t pos)
+{
+    return (map[pos / 64] >> (pos % 64)) & 1;
+}
+
+// offset of first FEND in [pos, pos + count) of map, count if none
+DSTATIC size_t find_fend(const uint64_t* map, size_t pos, size_t count)
+{
+    if (count == 0) return 0;   // pos may be the end of map
+
+    size_t bit = pos % 64;
+    size_t index = pos / 64;
+    uint64_t word = map[index] >> bit;
+
+    //frame end within the rest of first word
+    if (word) {
+        size_t offset = ctz64(word);
+        return offset < count ? offset : count;
+    }
+    //next words
+    for (size_t scanned = 64 - bit; scanned < count; scanned += 64) {
+        index += 1;
+        word = map[index];
+        if (word) {
+            size_t offset = scanned + ctz64(word);
+            return offset < count ? offset : count;
         }
     }
+    return count;
+}
 
-    //check crc
-    uint8_t data[] = {FEND};
-    if ( get_crc8(ps->buffer_rxdec, buffer_rxdec_stored, get_crc8(data, 1, 0)) ){
-        reset_buffer_rxdec(platform);
-        return CWAKE_ERROR_CRC;
+#ifdef CWAKE_TEST
+// limit kernels for tests and benchmarks, return level in use
+DSTATIC int select_kernels(int max_kernel)
+{
+    kernel_limit = max_kernel;
+    return kernel_level();
+}
+#endif
+
+// FRAME FORMATS
+static inline size_t data_max(uint8_t format)
+{
+    if (format == CWAKE_FRAME_CLASSIC && CLASSIC_DATA_MAX < CWAKE_DATA_MAX) {
+        return CLASSIC_DATA_MAX;
+    }
+    return CWAKE_DATA_MAX;
+}
+
+static inline size_t crc_size(uint8_t format)
+{
+    if (format == CWAKE_FRAME_CRC16) return 2;
+    if (format == CWAKE_FRAME_CRC32) return 4;
+    return CRC_SIZE;
+}
+
+// preamble, header, data and crc before stuffing
+static inline uint32_t unstuffed_size(uint8_t format, uint32_t size)
+{
+    uint32_t header_size = format == CWAKE_FRAME_CLASSIC ? HEADER_SIZE : EXT_HEADER_SIZE;
+    return PREAMBLE_SIZE + header_size + size + crc_size(format);
+}
+
+// crc of frame part in format, started from crc_init(format)
+static inline uint32_t crc_init(uint8_t format)
+{
+    return format == CWAKE_FRAME_CRC16 ? 0xFFFF : 0;
+}
+
+static inline uint32_t frame_crc(uint8_t format, const uint8_t* data, size_t size, uint32_t crc)
+{
+    if (format == CWAKE_FRAME_CRC16) return get_crc16(data, size, crc);
+    if (format == CWAKE_FRAME_CRC32) return get_crc32(data, size, crc);
+    return get_crc8(data, size, crc);
+}
+
+// write preamble and header of frame, start crc over them, return their size
+static inline uint32_t frame_header(uint8_t format, uint8_t addr, uint8_t cmd,
+                                    uint32_t size, uint8_t* header, uint32_t* crc)
+{
+    uint32_t header_size = PREAMBLE_SIZE + HEADER_SIZE;
+
+    header[0] = FEND;
+    header[1] = addr;
+    header[2] = cmd;
+    header[3] = size;
+    if (format != CWAKE_FRAME_CLASSIC) {
+        header[3] = format == CWAKE_FRAME_CRC16 ? EXT_FLAG_CRC16 : EXT_FLAG_CRC32;
+        header[4] = size & 0xFF;
+        header[5] = size >> 8;
+        header_size = PREAMBLE_SIZE + EXT_HEADER_SIZE;
     }
+    *crc = frame_crc(format, header, header_size, crc_init(format));
+    return header_size;
+}
 
-    //check addr (address filtering)
-    if ( platform->addr != 0 &&
-        platform->service.buffer_rxdec[ADDR_POS] != 0 &&
-        platform->service.buffer_rxdec[ADDR_POS] != platform->addr
-        ){
-        reset_buffer_rxdec(platform);
-        return CWAKE_ERROR_NONE;
+// stuff crc (LE) to dst
+static inline size_t stuff_frame_crc(uint8_t format, uint32_t crc, uint8_t* dst)
+{
+    uint8_t bytes[] = {crc & 0xFF, (crc >> 8) & 0xFF, (crc >> 16) & 0xFF, crc >> 24};
+    return stuff_scalar(bytes, crc_size(format), dst);
+}
+
+// stuff part of frame data to dst and update crc of frame
+static inline size_t stuff_frame_part(uint8_t format, const uint8_t* src, size_t size,
+                                      uint8_t* dst, uint32_t* crc)
+{
+    if (format == CWAKE_FRAME_CLASSIC) {
+        uint8_t crc8 = *crc;
+        size_t dst_len = stuff_crc8(src, size, dst, &crc8);
+        *crc = crc8;
+        return dst_len;
     }
+    *crc = frame_crc(format, src, size, *crc);
+    return stuff_kernel(src, size, dst);
+}
 
-    // ==== HANDLING ====
-    // call user handler
-    uint8_t* return_buffer = NULL;
-    uint8_t return_size = 0;
-    uint8_t cmd = platform->service.buffer_rxdec[CMD_POS];
-    platform->handle(cmd,
-                     platform->service.buffer_rxdec + DATA_POS,
-                     platform->service.buffer_rxdec[SIZE_POS],
-                     &return_buffer,
-                     &return_size
-                     );
+// encode frame into dst (worst case 1 + 2*(size + 4) bytes, 1 + 2*(size + 9)
+// for extended frames), return its size
+static uint32_t encode_frame(uint8_t addr, uint8_t cmd,
+                             const cwake_iovec* parts, uint32_t count, uint32_t size,
+                             uint8_t format, uint8_t* dst)
+{
+    uint8_t header[6]; // preamble and extended header at most
+    uint32_t crc = 0;
+    uint32_t header_size = frame_header(format, addr, cmd, size, header, &crc);
+    uint32_t dst_len = stuff(header, header_size, dst);
 
-    reset_buffer_rxdec(platform);
+    for (uint32_t i = 0; i < count; i++) {
+        dst_len += stuff_frame_part(format, parts[i].data, parts[i].size, dst + dst_len, &crc);
+    }
+    return dst_len + stuff_frame_crc(format, crc, dst + dst_len);
+}
 
-    // return user data to cwake_call if exist
-    if (return_buffer && return_size > 0) {
-        return cwake_call(platform->addr, cmd, return_buffer, return_size, platform);
+// ASYNC CALLS
+// Pending table is searched linearly, it is small and usually almost empty
+static struct cwake_pending* find_pending(struct cwake_service* ps, uint8_t addr, uint8_t cmd)
+{
+    for (uint32_t i = 0; i < CWAKE_PENDING_MAX; i++) {
+        struct cwake_pending* call = &ps->pending[i];
+        if (call->on_done && call->addr == addr && call->cmd == cmd) return call;
     }
-    return CWAKE_ERROR_NONE;
+    return NULL;
 }
 
-cwake_error cwake_call(uint8_t addr, uint8_t cmd,
-                       uint8_t* data, uint8_t size,
-                       cwake_platform* platform)
+// free entry before completion, so on_done may start the next call
+static void complete_pending(struct cwake_service* ps, struct cwake_pending* call,
+                             cwake_error err, const uint8_t* data, uint16_t size)
 {
-    uint8_t* work_buffer = platform->service.buffer_txdec;
-    uint32_t work_buffer_tail = 0;
+    cwake_done on_done = call->on_done;
+    call->on_done = NULL;
+    ps->pending_count -= 1;
+    on_done(call->ctx, err, data, size);
+}
 
-    if (size > WORK_BUFFER_SIZE - HEADER_SIZE - CRC_SIZE) {
-        return CWAKE_ERROR_INVALID_DATA;
+static void expire_pending(cwake_platform* platform)
+{
+    struct cwake_service* ps = &platform->service;
+
+    if (ps->pending_count == 0) return;
+    uint32_t now = platform->current_time_ms(platform->user);
+    for (uint32_t i = 0; i < CWAKE_PENDING_MAX; i++) {
+        struct cwake_pending* call = &ps->pending[i];
+        if (call->on_done && (int32_t)(now - call->deadline) >= 0) {
+            complete_pending(ps, call, CWAKE_ERROR_TIMEOUT, NULL, 0);
+        }
     }
+}
+
+// RESPONSE HANDOFF
+// Full-duplex receiver passes handler response to transmitter through one
+// slot: the owner side writes the frame, then publishes its size (release),
+// the other side reads size (acquire) before touching the frame.
+#ifdef __GNUC__
+#define LOAD_ACQUIRE(var)       __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+#else
+#define LOAD_ACQUIRE(var)       (*(volatile uint32_t*)&(var))
+#define STORE_RELEASE(var, val) (*(volatile uint32_t*)&(var) = (val))
+#endif
 
-    work_buffer[(work_buffer_tail)++] = FEND;
-    work_buffer[(work_buffer_tail)++] = addr;
-    work_buffer[(work_buffer_tail)++] = cmd;
-    work_buffer[(work_buffer_tail)++] = size;
-    memcpy(work_buffer + work_buffer_tail, data, size);
-    work_buffer_tail += size;
-    work_buffer[work_buffer_tail] = get_crc8(work_buffer, work_buffer_tail, 0);
-    work_buffer_tail += 1;
+// STATISTICS
+// Every counter has one writer (receiver or transmitter side), which adds
+// by a plain load and a relaxed store, so readers on other threads see
+// whole values without locks.
+#ifdef __GNUC__
+#define STAT_ADD(var, n)        __atomic_store_n(&(var), (var) + (n), __ATOMIC_RELAXED)
+#define STAT_STORE(var, val)    __atomic_store_n(&(var), (val), __ATOMIC_RELAXED)
+#define STAT_LOAD(var)          __atomic_load_n(&(var), __ATOMIC_RELAXED)
+#else
+#define STAT_ADD(var, n)        (*(volatile uint32_t*)&(var) = (var) + (n))
+#define STAT_STORE(var, val)    (*(volatile uint32_t*)&(var) = (val))
+#define STAT_LOAD(var)          (*(volatile const uint32_t*)&(var))
+#endif
 
-    uint8_t* stuff_buffer = platform->service.buffer_txenc;
-    uint32_t stuff_buffer_tail = 0;
+// TRACING
+// Events are claimed by a shared counter (receiver and transmitter may
+// trace at once) and published by their number: the writer clears it,
+// fills the slot and stores seq + 1 (release). The reader copies the slot
+// between two loads of its number and drops it if the number has changed.
+// Without GCC atomics only one thread may trace.
+#ifdef CWAKE_TRACE
+#ifdef __GNUC__
+#define TRACE_CLAIM(var)        __atomic_fetch_add(&(var), 1, __ATOMIC_RELAXED)
+#define TRACE_FENCE_RELEASE()   __atomic_thread_fence(__ATOMIC_RELEASE)
+#define TRACE_FENCE_ACQUIRE()   __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#else
+#define TRACE_CLAIM(var)        ((var)++)
+#define TRACE_FENCE_RELEASE()
+#define TRACE_FENCE_ACQUIRE()
+#endif
 
-    stuff_buffer_tail = stuff(work_buffer, work_buffer_tail, stuff_buffer);
-    if ( stuff_buffer_tail == 0 ) {
-        return CWAKE_ERROR_INVALID_DATA;
+static inline uint32_t trace_time(cwake_platform* platform)
+{
+    if (platform->current_time_us) return platform->current_time_us(platform->user);
+    return platform->current_time_ms(platform->user) * 1000;
+}
+
+static void trace_parts(cwake_platform* platform, uint8_t stage, cwake_error code,
+                        const cwake_iovec* parts, uint32_t count)
+{
+    struct cwake_trace* tr = &platform->service.trace;
+    union cwake_trace_slot event;
+
+    memset(&event, 0, sizeof(event));
+    event.event.time_us = trace_time(platform);
+    event.event.stage = stage;
+    event.event.code = (int8_t)code;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t stored = event.event.size < CWAKE_TRACE_BYTES ? event.event.size : CWAKE_TRACE_BYTES;
+        uint32_t part = CWAKE_TRACE_BYTES - stored;
+        if (part > parts[i].size) part = parts[i].size;
+        if (part) memcpy(event.event.data + stored, parts[i].data, part);
+        event.event.size += parts[i].size;
     }
-    DEBUG_PRINT("Tx: %s", format_hex_ascii(stuff_buffer, stuff_buffer_tail));
-    platform->write(stuff_buffer, stuff_buffer_tail);
 
-    return CWAKE_ERROR_NONE;
+    uint32_t seq = TRACE_CLAIM(tr->head);
+    union cwake_trace_slot* slot = &tr->slots[seq % CWAKE_TRACE_EVENTS];
+    STAT_STORE(slot->words[0], 0);
+    TRACE_FENCE_RELEASE();
+    for (size_t i = 1; i < sizeof(event.words) / 4; i++) STAT_STORE(slot->words[i], event.words[i]);
+    STORE_RELEASE(slot->words[0], seq + 1);
 }
 
-#undef DEBUG_PRINT
+static inline void trace(cwake_platform* platform, uint8_t stage, cwake_error code,
+                         const uint8_t* data, uint32_t size)
+{
+    cwake_iovec part = {data, size};
+    trace_parts(platform, stage, code, &part, 1);
+}
+
+#define TRACE(platform, stage, code, data, size) trace(platform, stage, code, data, size)
+#define TRACE_PARTS(platform, stage, code, parts, count) trace_parts(platform, stage, code, parts, count)
+#else
+#define TRACE(platform, stage, code, data, size)
+#define TRACE_PARTS(platform, stage, code, parts, count)
+#endif
+
+// log-scale histogram bucket of time in us
+static inline uint32_t stats_bucket(uint32_t us)
+{
+    uint32_t bucket = 0;
+    while (us && bucket < CWAKE_STATS_BUCKETS - 1) {
+        us >>= 1;
+        bucket += 1;
+    }
+    return bucket;
+}
+
+static inline void count_time(uint32_t* hist, uint32_t us)
+{
+    STAT_ADD(hist[stats_bucket(us)], 1);
+}
+
+static inline void count_tx(struct cwake_service* ps, uint32_t encoded, uint32_t escapes)
+{
+    STAT_ADD(ps->tx_stats.frames, 1);
+    STAT_ADD(ps->tx_stats.bytes, encoded);
+    STAT_ADD(ps->tx_stats.escapes, escapes);
+}
+
+// receive errors are counted by poll_frame, also those it resynchronizes after
+static inline void count_rx_error(cwake_platform* platform, cwake_error err)
+{
+    struct cwake_service* ps = &platform->service;
+
+    if (err) {
+        TRACE(platform, CWAKE_TRACE_ERROR, err, NULL, 0);
+    }
+    if (err == CWAKE_ERROR_CRC) STAT_ADD(ps->rx_stats.crc_errors, 1);
+    if (err == CWAKE_ERROR_TIMEOUT) STAT_ADD(ps->rx_stats.timeouts, 1);
+    if (err == CWAKE_ERROR_INVALID_DATA) STAT_ADD(ps->rx_stats.invalid, 1);
+}
+
+// response handed to transmitter since last read of receive buffer
+static inline void count_turnaround(cwake_platform* platform)
+{
+    if (!platform->current_time_us) return;
+    uint32_t now = platform->current_time_us(platform->user);
+    count_time(platform->service.rx_stats.turnaround_hist, now - platform->service.rx_read_us);
+}
+
+static void load_counters(uint32_t* dst, const uint32_t* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++) dst[i] = STAT_LOAD(src[i]);
+}
+
+// TRANSMIT QUEUE
+// Data not accepted by write callback is kept in ring and written before
+// any new data, when port becomes writable (cwake_poll) or on next call.
+static inline uint32_t write_some(cwake_platform* platform, const uint8_t* data, uint32_t size)
+{
+    uint32_t written = platform->write(platform->user, (uint8_t*)data, size);
+    return written > size ? size : written;
+}
+
+#if CWAKE_TX_QUEUE_SIZE
+static inline uint32_t tx_queue_free(const struct cwake_service* ps)
+{
+    return CWAKE_TX_QUEUE_SIZE - (ps->tx_queue_head - ps->tx_queue_tail);
+}
+
+static void push_tx_queue(struct cwake_service* ps, const uint8_t* data, uint32_t size)
+{
+    while (size) {
+        uint32_t pos = ps->tx_queue_head % CWAKE_TX_QUEUE_SIZE;
+        uint32_t part = CWAKE_TX_QUEUE_SIZE - pos < size ? CWAKE_TX_QUEUE_SIZE - pos : size;
+        memcpy(ps->tx_queue + pos, data, part);
+        ps->tx_queue_head += part;
+        data += part;
+        size -= part;
+    }
+}
+
+// write queued data until write callback accepts less than offered
+static void flush_tx_queue(cwake_platform* platform)
+{
+    struct cwake_service* ps = &platform->service;
+
+    while (ps->tx_queue_head != ps->tx_queue_tail) {
+        uint32_t pos = ps->tx_queue_tail % CWAKE_TX_QUEUE_SIZE;
+        uint32_t size = ps->tx_queue_head - ps->tx_queue_tail;
+        if (size > CWAKE_TX_QUEUE_SIZE - pos) size = CWAKE_TX_QUEUE_SIZE - pos;
+
+        uint32_t written = write_some(platform, ps->tx_queue + pos, size);
+        ps->tx_queue_tail += written;
+        if (written < size) return;
+    }
+}
+#else
+// without queue nothing is kept, batch buffer holds its unwritten rest
+static inline uint32_t tx_queue_free(const struct cwake_service* ps)
+{
+    (void)ps;
+    return 0;
+}
+
+static inline void push_tx_queue(struct cwake_service* ps, const uint8_t* data, uint32_t size)
+{
+    (void)ps; (void)data; (void)size;
+}
+
+static inline void flush_tx_queue(cwake_platform* platform)
+{
+    (void)platform;
+}
+#endif
+
+// write frame segments, the part not accepted by port is queued
+static cwake_error transmit(cwake_platform* platform,
+                            const cwake_iovec* segments, uint32_t count)
+{
+    struct cwake_service* ps = &platform->service;
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < count; i++) size += segments[i].size;
+
+    flush_tx_queue(platform);
+    if (CWAKE_TX_QUEUE_SIZE && tx_queue_free(ps) < size) {
+        return CWAKE_ERROR_BUSY;
+    }
+
+    // queued data goes first
+    uint32_t written = 0;
+    if (ps->tx_queue_head == ps->tx_queue_tail) {
+        if (count == 1) {
+            written = write_some(platform, segments[0].data, segments[0].size);
+        } else {
+            written = platform->writev(platform->user, segments, count);
+            if (written > size) written = size;
+        }
+    }
+
+    // frame written partly cannot be completed without queue
+    if (CWAKE_TX_QUEUE_SIZE == 0 && written < size) {
+        return CWAKE_ERROR_IO;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t skip = written < segments[i].size ? written : segments[i].size;
+        push_tx_queue(ps, segments[i].data + skip, segments[i].size - skip);
+        written -= skip;
+    }
+    return CWAKE_ERROR_NONE;
+}
+
+// transmit one encoded frame of decoded length (statistics)
+static cwake_error transmit_frame(cwake_platform* platform, const cwake_iovec* segments,
+                                  uint32_t count, uint32_t length)
+{
+    struct cwake_service* ps = &platform->service;
+    cwake_error err = transmit(platform, segments, count);
+
+    if (err) {
+        if (err == CWAKE_ERROR_BUSY) STAT_ADD(ps->tx_stats.busy, 1);
+        TRACE_PARTS(platform, CWAKE_TRACE_ERROR, err, segments, count);
+        return err;
+    }
+    TRACE_PARTS(platform, CWAKE_TRACE_TX, CWAKE_ERROR_NONE, segments, count);
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < count; i++) size += segments[i].size;
+    count_tx(ps, size, size - length);
+    return CWAKE_ERROR_NONE;
+}
+
+// write all frames stored in batch buffer, the part not accepted by port
+// is queued or (if queue is full) left at the start of batch buffer
+static cwake_error flush_batch(cwake_platform* platform)
+{
+    struct cwake_service* ps = &platform->service;
+
+    if (ps->batch_tail == 0) return CWAKE_ERROR_NONE;
+    DEBUG_PRINT_HEX("Tx: %s", ps->batch_buffer, ps->batch_tail);
+
+    flush_tx_queue(platform);
+    uint32_t written = 0;
+    if (ps->tx_queue_head == ps->tx_queue_tail) {
+        written = write_some(platform, ps->batch_buffer, ps->batch_tail);
+    }
+
+    uint32_t rest = ps->batch_tail - written;
+    if (rest > tx_queue_free(ps)) {
+        memmove(ps->batch_buffer, ps->batch_buffer + written, rest);
+        ps->batch_tail = rest;
+        return CWAKE_ERROR_BUSY;
+    }
+    push_tx_queue(ps, ps->batch_buffer + written, rest);
+    ps->batch_tail = 0;
+    return CWAKE_ERROR_NONE;
+}
+
+// ========================================================== Public functional
+cwake_error cwake_init(cwake_platform* platform)
+{
+#if !CWAKE_FULL_DUPLEX
+    if (platform->full_duplex) return CWAKE_ERROR_INVALID_DATA;
+#endif
+#ifdef CWAKE_SIMD_X86
+    if (__atomic_load_n(&cpu_kernel, __ATOMIC_RELAXED) < 0) detect_kernel();
+#endif
+    reset_buffer_rx(platform);
+    reset_buffer_rxdec(platform);
+    platform->service.batch_buffer = NULL;
+    platform->service.batch_tail = 0;
+    platform->service.tx_queue_head = 0;
+    platform->service.tx_queue_tail = 0;
+#if CWAKE_FULL_DUPLEX
+    platform->service.rx_response_size = 0;
+    platform->service.rx_response_escapes = 0;
+#endif
+    platform->service.rx_read_us = 0;
+    memset(&platform->service.rx_stats, 0, sizeof(platform->service.rx_stats));
+    memset(&platform->service.tx_stats, 0, sizeof(platform->service.tx_stats));
+#ifdef CWAKE_TRACE
+    memset(&platform->service.trace, 0, sizeof(platform->service.trace));
+#endif
+    platform->service.pending_count = 0;
+    memset(platform->service.pending, 0, sizeof(platform->service.pending));
+#if CWAKE_HANDLERS
+    memset(platform->service.handler_index, 0, sizeof(platform->service.handler_index));
+    memset(platform->service.handlers, 0, sizeof(platform->service.handlers));
+#endif
+    stop_timeout_timer(platform);
+
+    return CWAKE_ERROR_NONE;
+}
+
+uint8_t cwake_crc8(const uint8_t* data, size_t size, uint8_t crc)
+{
+    return get_crc8(data, size, crc);
+}
+
+uint16_t cwake_crc16(const uint8_t* data, size_t size, uint16_t crc)
+{
+    return get_crc16(data, size, crc);
+}
+
+uint32_t cwake_crc32(const uint8_t* data, size_t size, uint32_t crc)
+{
+    return get_crc32(data, size, crc);
+}
+
+// free space at buffer end below which buffer is compacted before reading
+// (moves are paid once per at least a quarter of buffer received)
+#define RX_COMPACT_SPACE (CWAKE_RX_BUFFER_SIZE / 4)
+
+// read into free space at buffer end. When it runs low (or buffer holds
+// nothing), decoded part of current frame is moved to buffer start first,
+// encoded rest right behind it (the gap left by destuffing is closed), so
+// a whole frame always fits.
+static uint32_t read_buffer_rx(cwake_platform* platform)
+{
+    struct cwake_service* ps = &platform->service;
+    uint32_t decoded = ps->rx_dend - ps->rx_frame;
+    uint32_t encoded = ps->rx_head - ps->rx_tail;
+    uint32_t compact = decoded + encoded == 0 ||
+                       CWAKE_RX_BUFFER_SIZE - ps->rx_head < RX_COMPACT_SPACE;
+
+    if (compact && (ps->rx_frame || ps->rx_tail != ps->rx_dend)) {
+        memmove(ps->buffer_rx, ps->buffer_rx + ps->rx_frame, decoded);
+        memmove(ps->buffer_rx + decoded, ps->buffer_rx + ps->rx_tail, encoded);
+        ps->rx_frame = 0;
+        ps->rx_dend = decoded;
+        ps->rx_tail = decoded;
+        ps->rx_head = decoded + encoded;
+        scan_fend(ps->buffer_rx, ps->rx_tail, encoded, ps->fend_map);
+    }
+
+    uint32_t space = CWAKE_RX_BUFFER_SIZE - ps->rx_head;
+    if (space == 0) return 0;
+
+    uint32_t received = platform->read(platform->user, ps->buffer_rx + ps->rx_head, space);
+    if (received > space) received = space;
+    if (received) {
+        DEBUG_PRINT_HEX("Rx: %s", ps->buffer_rx + ps->rx_head, received);
+        TRACE(platform, CWAKE_TRACE_RX, CWAKE_ERROR_NONE, ps->buffer_rx + ps->rx_head, received);
+        STAT_ADD(ps->rx_stats.bytes, received);
+        if (platform->current_time_us) ps->rx_read_us = platform->current_time_us(platform->user);
+        //mark all frame delimiters of the chunk at once
+        scan_fend(ps->buffer_rx, ps->rx_head, received, ps->fend_map);
+        ps->rx_head += received;
+    }
+    return received;
+}
+
+// FEND behind a partially decoded frame is left to close that frame
+static inline void skip_preamble(struct cwake_service* ps)
+{
+    if (ps->rx_dend != ps->rx_frame) return;
+    while (ps->rx_tail != ps->rx_head && is_fend_at(ps->fend_map, ps->rx_tail)) {
+        ps->rx_tail += 1;
+        ps->rx_parsed += 1;
+        ps->preamble_is_received = 1;
+    }
+}
+
+static cwake_error send_frame(uint8_t addr, uint8_t cmd,
+                              const cwake_iovec* parts, uint32_t count,
+                              uint8_t format, cwake_platform* platform);
+
+// receive (if no frame end is buffered), decode and handle one frame
+static cwake_error parse_frame(cwake_platform* platform, uint8_t may_read, uint8_t* handled)
+{
+    struct cwake_service* ps = &platform->service;
+
+#if CWAKE_FULL_DUPLEX
+    // response of previous frame is not taken by transmitter yet; the
+    // receive timer still expires, so its deadline does not stay due
+    if (platform->full_duplex && LOAD_ACQUIRE(ps->rx_response_size)) {
+        if (may_read && is_timeout(platform)) {
+            reset_buffer_rxdec(platform);
+            stop_timeout_timer(platform);
+            return CWAKE_ERROR_TIMEOUT;
+        }
+        return CWAKE_ERROR_BUSY;
+    }
+#endif
+
+    // ==== RECEIVING ====
+    // read into free space of buffer if buffered data holds no frame end
+    skip_preamble(ps);
+    uint32_t stored = ps->rx_head - ps->rx_tail;
+    uint32_t frame_size = find_fend(ps->fend_map, ps->rx_tail, stored);
+
+    if (frame_size == stored && may_read) {
+        if ( is_timeout(platform) ) {
+            reset_buffer_rxdec(platform);
+            stop_timeout_timer(platform);
+            return CWAKE_ERROR_TIMEOUT;
+        }
+
+        if (read_buffer_rx(platform)) {
+            stop_timeout_timer(platform);
+            skip_preamble(ps);
+            stored = ps->rx_head - ps->rx_tail;
+            frame_size = find_fend(ps->fend_map, ps->rx_tail, stored);
+        }
+    }
+
+    // ==== FRAMING ====
+    //frame lasts up to the end of received data (more data may follow)
+    uint8_t frame_is_open = (frame_size == stored);
+
+    //incomplete escape sequence is left for next read
+    if (frame_is_open && frame_size && ps->buffer_rx[ps->rx_tail + frame_size - 1] == FESC) {
+        frame_size -= 1;
+    }
+    if (frame_size == 0 && frame_is_open) {
+        return CWAKE_ERROR_NONE;
+    }
+
+    uint32_t frame_start = ps->rx_tail;
+    ps->rx_tail += frame_size;
+    ps->rx_parsed += frame_size;
+
+    //check for first byte in frame is preamble
+    if(ps->rx_dend == ps->rx_frame && !ps->preamble_is_received) {
+        return CWAKE_ERROR_INVALID_DATA;
+    }
+    ps->preamble_is_received = 0;
+
+    // ==== DESTUFFING ====
+    // in place: decoded data ends before encoded data it is read from
+    uint32_t rxdec_buffer_size = CWAKE_FRAME_MAX - (ps->rx_dend - ps->rx_frame);
+
+    // crc is carried along over partial frames (nothing is left to decode
+    // if FEND closes a partial frame)
+    size_t destuffed = 0;
+    if (frame_size) {
+        destuffed = destuff_crc8(ps->buffer_rx + frame_start, frame_size,
+                                 ps->buffer_rx + ps->rx_dend, rxdec_buffer_size,
+                                 &ps->rx_crc);
+        if (destuffed == 0) {
+            reset_buffer_rxdec(platform);
+            return CWAKE_ERROR_INVALID_DATA;
+        }
+    }
+    ps->rx_dend += destuffed;
+    STAT_ADD(ps->rx_stats.escapes, frame_size - destuffed);
+
+    // ==== VALIDATING ====
+    uint8_t* frame = ps->buffer_rx + ps->rx_frame;
+    uint32_t buffer_rxdec_stored = ps->rx_dend - ps->rx_frame;
+    //check complete header
+    if ( buffer_rxdec_stored < HEADER_SIZE ) {
+        if (frame_is_open) {
+            start_timeout_timer(platform);
+            return CWAKE_ERROR_NONE;
+        }
+        else {
+            reset_buffer_rxdec(platform);
+            return CWAKE_ERROR_INVALID_DATA;
+        }
+    }
+    //extended frame: flag in place of size code, then 16-bit length
+    uint8_t format = CWAKE_FRAME_CLASSIC;
+    uint32_t header_size = HEADER_SIZE;
+    uint32_t data_size = frame[SIZE_POS];
+    if (frame[SIZE_POS] == EXT_FLAG_CRC16 || frame[SIZE_POS] == EXT_FLAG_CRC32) {
+        format = frame[SIZE_POS] == EXT_FLAG_CRC16 ? CWAKE_FRAME_CRC16 : CWAKE_FRAME_CRC32;
+        header_size = EXT_HEADER_SIZE;
+        if ( buffer_rxdec_stored < header_size ) {
+            if (frame_is_open) {
+                start_timeout_timer(platform);
+                return CWAKE_ERROR_NONE;
+            }
+            reset_buffer_rxdec(platform);
+            return CWAKE_ERROR_INVALID_DATA;
+        }
+        data_size = frame[SIZE_POS + 1] | frame[SIZE_POS + 2] << 8;
+    }
+    //check correct size code
+    if (data_size > data_max(format)) {
+        reset_buffer_rxdec(platform);
+        return CWAKE_ERROR_INVALID_DATA;
+    }
+
+    //check complete request
+    uint32_t frame_length = header_size + data_size + crc_size(format);
+    if ( buffer_rxdec_stored < frame_length ){
+        if (frame_is_open) {
+            start_timeout_timer(platform);
+            return CWAKE_ERROR_NONE;
+        }
+        else {
+            reset_buffer_rxdec(platform);
+            return CWAKE_ERROR_INVALID_DATA;
+        }
+    }
+
+    //check crc (CRC-8 is accumulated while destuffing, CRC-16/32 computed
+    //here over preamble and frame, trailing bytes must not follow)
+    uint8_t* data = frame + header_size;
+    uint8_t crc_error = ps->rx_crc != 0;
+    if (format != CWAKE_FRAME_CLASSIC) {
+        uint8_t preamble = PREAMBLE;
+        uint32_t crc = frame_crc(format, &preamble, PREAMBLE_SIZE, crc_init(format));
+        crc = frame_crc(format, frame, header_size + data_size, crc);
+        uint32_t received = 0;
+        for (uint32_t i = crc_size(format); i > 0; i--) {
+            received = received << 8 | data[data_size + i - 1];
+        }
+        crc_error = crc != received || buffer_rxdec_stored != frame_length;
+    }
+    if ( crc_error ){
+        reset_buffer_rxdec(platform);
+        return CWAKE_ERROR_CRC;
+    }
+    STAT_ADD(ps->rx_stats.frames, 1);
+    TRACE(platform, CWAKE_TRACE_FRAME, CWAKE_ERROR_NONE, frame, header_size + data_size);
+
+    //response to async call (any own address)
+    if (ps->pending_count) {
+        struct cwake_pending* call = find_pending(ps, frame[ADDR_POS],
+                                                  frame[CMD_POS]);
+        if (call) {
+            complete_pending(ps, call, CWAKE_ERROR_NONE, data, data_size);
+            *handled = 1;
+            reset_buffer_rxdec(platform);
+            return CWAKE_ERROR_NONE;
+        }
+    }
+
+    //check addr (address filtering)
+    if ( platform->addr != 0 &&
+        frame[ADDR_POS] != 0 &&
+        frame[ADDR_POS] != platform->addr
+        ){
+        STAT_ADD(ps->rx_stats.filtered, 1);
+        reset_buffer_rxdec(platform);
+        return CWAKE_ERROR_NONE;
+    }
+
+    // ==== HANDLING ====
+    // call user handler
+    uint8_t* return_buffer = NULL;
+    uint16_t return_size = 0;
+    uint8_t cmd = frame[CMD_POS];
+    uint32_t handler_start = platform->current_time_us ? platform->current_time_us(platform->user) : 0;
+    ps->rx_format = format;
+#if CWAKE_HANDLERS
+    uint8_t index = ps->handler_index[cmd];
+    if (index) {
+        struct cwake_handler_entry* entry = &ps->handlers[index - 1];
+        if (entry->max_response) return_buffer = ps->rx_return;
+        entry->fn(entry->ctx, cmd,
+                  data,
+                  data_size,
+                  &return_buffer,
+                  &return_size
+                  );
+    } else
+#endif
+    if (platform->handle) {
+        platform->handle(platform->user, cmd,
+                         data,
+                         data_size,
+                         &return_buffer,
+                         &return_size
+                         );
+    }
+    *handled = 1;
+    STAT_ADD(ps->rx_stats.handled, 1);
+    if (platform->current_time_us) {
+        uint32_t handler_us = platform->current_time_us(platform->user) - handler_start;
+        STAT_ADD(ps->rx_stats.handler_us, handler_us);
+        count_time(ps->rx_stats.handler_hist, handler_us);
+    }
+
+    reset_buffer_rxdec(platform);
+
+    // return user data to cwake_call if exist
+    // (extended request is answered in its format)
+    if (return_buffer && return_size > 0) {
+        cwake_iovec part = {return_buffer, return_size};
+        if (format == CWAKE_FRAME_CLASSIC) format = platform->frame_format;
+        if (!platform->full_duplex) {
+            cwake_error err = send_frame(platform->addr, cmd, &part, 1, format, platform);
+            if (err == CWAKE_ERROR_NONE) count_turnaround(platform);
+            return err;
+        }
+#if CWAKE_FULL_DUPLEX
+        // full-duplex: encoded here, written by cwake_poll_tx
+        if (return_size > data_max(format)) {
+            return CWAKE_ERROR_INVALID_DATA;
+        }
+        uint32_t size = encode_frame(platform->addr, cmd, &part, 1, return_size,
+                                     format, ps->rx_response);
+        ps->rx_response_escapes = size - unstuffed_size(format, return_size);
+        STORE_RELEASE(ps->rx_response_size, size);
+        count_turnaround(platform);
+#endif
+    }
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_register_handler(cwake_platform* platform, uint8_t cmd,
+                                   cwake_handler fn, void* ctx,
+                                   uint16_t max_response)
+{
+    if (max_response > CWAKE_DATA_MAX) {
+        return CWAKE_ERROR_INVALID_DATA;
+    }
+#if CWAKE_HANDLERS
+    struct cwake_service* ps = &platform->service;
+    uint32_t index = ps->handler_index[cmd];
+
+    if (!fn) {
+        // entry is free again (fn == NULL)
+        if (index) ps->handlers[index - 1].fn = NULL;
+        ps->handler_index[cmd] = 0;
+        return CWAKE_ERROR_NONE;
+    }
+    if (!index) {
+        while (index < CWAKE_HANDLERS && ps->handlers[index].fn) index++;
+        if (index == CWAKE_HANDLERS) return CWAKE_ERROR_BUSY;
+        index += 1;
+    }
+    struct cwake_handler_entry* entry = &ps->handlers[index - 1];
+    entry->fn = fn;
+    entry->ctx = ctx;
+    entry->max_response = max_response;
+    ps->handler_index[cmd] = index;
+    return CWAKE_ERROR_NONE;
+#else
+    (void)cmd; (void)ctx;
+    return fn ? CWAKE_ERROR_INVALID_DATA : CWAKE_ERROR_NONE;
+#endif
+}
+
+// RESYNCHRONIZATION
+// Frame broken by line noise is dropped at once and parsing goes on from
+// the next plausible frame start in buffered data, so frames behind noise
+// are not left for later calls. Every FEND starts a frame (it is never
+// escaped); starts whose header cannot belong to a valid frame are skipped
+// without decoding.
+
+// header behind FEND at rx_tail may start a valid frame: classic size code
+// is in range and the frame fits before the next buffered FEND (decoded
+// data is never longer than encoded); incomplete headers are plausible
+static uint8_t is_plausible_start(const struct cwake_service* ps)
+{
+    uint32_t pos = ps->rx_tail;
+    while (pos != ps->rx_head && is_fend_at(ps->fend_map, pos)) pos++;
+    uint32_t stored = ps->rx_head - pos;
+    uint32_t encoded = find_fend(ps->fend_map, pos, stored);
+    uint8_t closed = encoded < stored;
+    uint8_t header[3];                  // ADDR, CMD, N
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; count < HEADER_SIZE && i < encoded; i++) {
+        uint8_t byte = ps->buffer_rx[pos + i];
+        if (byte == FESC) {
+            if (++i == encoded) break;
+            if (ps->buffer_rx[pos + i] != TFEND && ps->buffer_rx[pos + i] != TFESC) return 0;
+            byte = ps->buffer_rx[pos + i] == TFEND ? FEND : FESC;
+        }
+        header[count++] = byte;
+    }
+    if (count < HEADER_SIZE) return !closed;
+
+    uint8_t size = header[SIZE_POS];
+    if (size == EXT_FLAG_CRC16 || size == EXT_FLAG_CRC32) return 1;
+    if (size > data_max(CWAKE_FRAME_CLASSIC)) return 0;
+    return !closed || encoded >= HEADER_SIZE + size + CRC_SIZE;
+}
+
+// errors of broken frames, parsing can go on behind them
+static inline uint8_t is_frame_error(cwake_error err)
+{
+    return err == CWAKE_ERROR_INVALID_DATA || err == CWAKE_ERROR_CRC;
+}
+
+// skip implausible frame starts (counted as invalid frames), 1 if a frame
+// start is buffered
+static uint8_t resync(cwake_platform* platform)
+{
+    struct cwake_service* ps = &platform->service;
+
+    while (ps->rx_tail != ps->rx_head) {
+        if (is_fend_at(ps->fend_map, ps->rx_tail) && is_plausible_start(ps)) return 1;
+        skip_preamble(ps);
+        uint32_t skipped = find_fend(ps->fend_map, ps->rx_tail, ps->rx_head - ps->rx_tail);
+        ps->rx_tail += skipped;
+        ps->rx_parsed += skipped;
+        ps->preamble_is_received = 0;
+        count_rx_error(platform, CWAKE_ERROR_INVALID_DATA);
+    }
+    return 0;
+}
+
+// parse frame, on frame error go on from next plausible start; every error
+// is counted, the first one is returned
+static cwake_error poll_frame(cwake_platform* platform, uint8_t may_read, uint8_t* handled)
+{
+    cwake_error err = parse_frame(platform, may_read, handled);
+    cwake_error first = err;
+
+    count_rx_error(platform, err);
+    while (is_frame_error(err) && !*handled && resync(platform)) {
+        err = parse_frame(platform, 0, handled);
+        count_rx_error(platform, err);
+    }
+    return first;
+}
+
+cwake_error cwake_poll(cwake_platform* platform)
+{
+    uint8_t handled = 0;
+    if (!platform->full_duplex) flush_tx_queue(platform);
+    expire_pending(platform);
+    return poll_frame(platform, 1, &handled);
+}
+
+cwake_error cwake_poll_tx(cwake_platform* platform)
+{
+    struct cwake_service* ps = &platform->service;
+
+    flush_tx_queue(platform);
+
+#if CWAKE_FULL_DUPLEX
+    uint32_t size = LOAD_ACQUIRE(ps->rx_response_size);
+    if (size) {
+        DEBUG_PRINT_HEX("Tx: %s", ps->rx_response, size);
+        cwake_iovec frame = {ps->rx_response, size};
+        cwake_error err = transmit(platform, &frame, 1);
+        if (err) {
+            STAT_ADD(ps->tx_stats.busy, 1);
+            return err;
+        }
+        TRACE(platform, CWAKE_TRACE_TX, CWAKE_ERROR_NONE, ps->rx_response, size);
+        count_tx(ps, size, ps->rx_response_escapes);
+        STORE_RELEASE(ps->rx_response_size, 0);
+    }
+#else
+    (void)ps;
+#endif
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_poll_batch(cwake_platform* platform,
+                             uint32_t max_frames, uint32_t* handled)
+{
+    struct cwake_service* ps = &platform->service;
+    cwake_error err = CWAKE_ERROR_NONE;
+    uint32_t frames = 0;
+
+    uint8_t may_read = 1;
+    uint32_t tail = 0;
+
+    if (!platform->full_duplex) flush_tx_queue(platform);
+    expire_pending(platform);
+
+    // read once, then handle buffered frames while parsing makes progress;
+    // broken frames are skipped, the first error is returned
+    cwake_error frame_err = CWAKE_ERROR_NONE;
+    do {
+        uint8_t frame_handled = 0;
+        tail = ps->rx_parsed;
+        frame_err = poll_frame(platform, may_read, &frame_handled);
+        if (err == CWAKE_ERROR_NONE) err = frame_err;
+        frames += frame_handled;
+        may_read = 0;
+    } while ((frame_err == CWAKE_ERROR_NONE || is_frame_error(frame_err)) &&
+             frames < max_frames && ps->rx_parsed != tail);
+
+    if (handled) *handled = frames;
+    return err;
+}
+
+cwake_error cwake_call(uint8_t addr, uint8_t cmd,
+                       uint8_t* data, uint16_t size,
+                       cwake_platform* platform)
+{
+    cwake_iovec part = {data, size};
+    return cwake_callv(addr, cmd, &part, 1, platform);
+}
+
+static inline int has_escapes(const uint8_t* data, size_t size)
+{
+    return memchr(data, FEND, size) || memchr(data, FESC, size);
+}
+
+cwake_error cwake_call_async(uint8_t addr, uint8_t cmd,
+                             uint8_t* data, uint16_t size,
+                             cwake_done on_done, void* ctx, uint32_t timeout_ms,
+                             cwake_platform* platform)
+{
+    struct cwake_service* ps = &platform->service;
+
+    //pending table belongs to receiver, transmitter may run on other thread
+    if (platform->full_duplex || !on_done) {
+        return CWAKE_ERROR_INVALID_DATA;
+    }
+    if (ps->pending_count == CWAKE_PENDING_MAX || find_pending(ps, addr, cmd)) {
+        return CWAKE_ERROR_BUSY;
+    }
+
+    cwake_error err = cwake_call(addr, cmd, data, size, platform);
+    if (err) return err;
+
+    struct cwake_pending* call = ps->pending;
+    while (call->on_done) call++;
+    call->on_done = on_done;
+    call->ctx = ctx;
+    call->deadline = platform->current_time_ms(platform->user) + timeout_ms;
+    call->addr = addr;
+    call->cmd = cmd;
+    ps->pending_count += 1;
+    return CWAKE_ERROR_NONE;
+}
+
+// send frame in format (see cwake_callv)
+static cwake_error send_frame(uint8_t addr, uint8_t cmd,
+                              const cwake_iovec* parts, uint32_t count,
+                              uint8_t format, cwake_platform* platform)
+{
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < count; i++) size += parts[i].size;
+
+    // frame must fit into receiver work buffer (see VALIDATING)
+    if (size > data_max(format)) {
+        return CWAKE_ERROR_INVALID_DATA;
+    }
+
+    // header, data and crc are stuffed straight into the tx buffer
+    // (or behind previous frames into the batch buffer)
+    struct cwake_service* ps = &platform->service;
+    uint8_t* stuff_buffer = ps->buffer_txenc;
+    uint32_t stuff_buffer_tail = 0;
+    uint8_t batching = 0;
+
+    if (ps->batch_buffer) {
+        // worst case: everything but preamble is escaped
+        uint32_t header_size = format == CWAKE_FRAME_CLASSIC ? HEADER_SIZE : EXT_HEADER_SIZE;
+        uint32_t frame_max = PREAMBLE_SIZE + 2*(header_size + size + crc_size(format));
+        if (ps->batch_size - ps->batch_tail < frame_max && flush_batch(platform)) {
+            STAT_ADD(ps->tx_stats.busy, 1);
+            return CWAKE_ERROR_BUSY;
+        }
+        if (ps->batch_size - ps->batch_tail >= frame_max) {
+            stuff_buffer = ps->batch_buffer + ps->batch_tail;
+            batching = 1;
+        }
+    }
+
+    if (batching || !platform->writev) {
+        stuff_buffer_tail = encode_frame(addr, cmd, parts, count, size, format, stuff_buffer);
+
+        if (batching) {
+            TRACE(platform, CWAKE_TRACE_TX, CWAKE_ERROR_NONE, stuff_buffer, stuff_buffer_tail);
+            ps->batch_tail += stuff_buffer_tail;
+            count_tx(ps, stuff_buffer_tail, stuff_buffer_tail - unstuffed_size(format, size));
+            return CWAKE_ERROR_NONE;
+        }
+        DEBUG_PRINT_HEX("Tx: %s", stuff_buffer, stuff_buffer_tail);
+        cwake_iovec frame = {stuff_buffer, stuff_buffer_tail};
+        return transmit_frame(platform, &frame, 1, unstuffed_size(format, size));
+    }
+
+    // gather: escape-free parts are written in place, the rest is stuffed
+    // into the tx buffer between them
+    uint8_t header[6];
+    uint32_t crc = 0;
+    stuff_buffer_tail = stuff(header, frame_header(format, addr, cmd, size, header, &crc),
+                              stuff_buffer);
+    cwake_iovec segments[GATHER_SEGMENTS_MAX];
+    uint32_t segments_count = 0;
+    uint32_t segment_start = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (parts[i].size >= GATHER_PART_MIN_SIZE &&
+            segments_count + 3 <= GATHER_SEGMENTS_MAX &&
+            !has_escapes(parts[i].data, parts[i].size)) {
+            crc = frame_crc(format, parts[i].data, parts[i].size, crc);
+            if (stuff_buffer_tail > segment_start) {
+                segments[segments_count].data = stuff_buffer + segment_start;
+                segments[segments_count++].size = stuff_buffer_tail - segment_start;
+            }
+            segments[segments_count++] = parts[i];
+            segment_start = stuff_buffer_tail;
+        }
+        else {
+            stuff_buffer_tail += stuff_frame_part(format, parts[i].data, parts[i].size,
+                                                  stuff_buffer + stuff_buffer_tail, &crc);
+        }
+    }
+    stuff_buffer_tail += stuff_frame_crc(format, crc, stuff_buffer + stuff_buffer_tail);
+    segments[segments_count].data = stuff_buffer + segment_start;
+    segments[segments_count++].size = stuff_buffer_tail - segment_start;
+
+    for (uint32_t i = 0; i < segments_count; i++) {
+        DEBUG_PRINT_HEX("Tx: %s", segments[i].data, segments[i].size);
+    }
+    return transmit_frame(platform, segments, segments_count, unstuffed_size(format, size));
+}
+
+cwake_error cwake_callv(uint8_t addr, uint8_t cmd,
+                        const cwake_iovec* parts, uint32_t count,
+                        cwake_platform* platform)
+{
+    return send_frame(addr, cmd, parts, count, platform->frame_format, platform);
+}
+
+cwake_error cwake_respond(uint8_t cmd, const uint8_t* data, uint16_t size,
+                          uint8_t format, cwake_platform* platform)
+{
+    cwake_iovec part = {data, size};
+    if (format == CWAKE_FRAME_CLASSIC) format = platform->frame_format;
+    return send_frame(platform->addr, cmd, &part, 1, format, platform);
+}
+
+cwake_error cwake_batch_begin(cwake_platform* platform,
+                              uint8_t* buffer, uint32_t size)
+{
+    struct cwake_service* ps = &platform->service;
+
+    if (ps->batch_buffer) {
+        return CWAKE_ERROR_BUSY;
+    }
+    ps->batch_buffer = buffer;
+    ps->batch_size = size;
+    ps->batch_tail = 0;
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_batch_flush(cwake_platform* platform)
+{
+    if (platform->service.batch_buffer) {
+        cwake_error err = flush_batch(platform);
+        if (err) return err;
+        platform->service.batch_buffer = NULL;
+    }
+    return CWAKE_ERROR_NONE;
+}
+
+uint32_t cwake_tx_pending(const cwake_platform* platform)
+{
+    return platform->service.tx_queue_head - platform->service.tx_queue_tail;
+}
+
+void cwake_stats_snapshot(const cwake_platform* platform, cwake_stats* stats)
+{
+    load_counters((uint32_t*)&stats->rx, (const uint32_t*)&platform->service.rx_stats,
+                  sizeof(stats->rx) / sizeof(uint32_t));
+    load_counters((uint32_t*)&stats->tx, (const uint32_t*)&platform->service.tx_stats,
+                  sizeof(stats->tx) / sizeof(uint32_t));
+}
+
+void cwake_stats_reset(cwake_platform* platform)
+{
+    memset(&platform->service.rx_stats, 0, sizeof(platform->service.rx_stats));
+    memset(&platform->service.tx_stats, 0, sizeof(platform->service.tx_stats));
+}
+
+#ifdef CWAKE_TRACE
+uint32_t cwake_trace_dump(const cwake_platform* platform, cwake_trace_event* events, uint32_t max)
+{
+    const struct cwake_trace* tr = &platform->service.trace;
+    uint32_t head = LOAD_ACQUIRE(tr->head);
+    uint32_t count = head < CWAKE_TRACE_EVENTS ? head : CWAKE_TRACE_EVENTS;
+    uint32_t copied = 0;
+
+    if (count > max) count = max;
+    for (uint32_t seq = head - count; seq != head; seq++) {
+        const union cwake_trace_slot* slot = &tr->slots[seq % CWAKE_TRACE_EVENTS];
+        union cwake_trace_slot event;
+
+        // not published yet or already reused by a later event
+        if (LOAD_ACQUIRE(slot->words[0]) != seq + 1) continue;
+        for (size_t i = 1; i < sizeof(event.words) / 4; i++) event.words[i] = STAT_LOAD(slot->words[i]);
+        TRACE_FENCE_ACQUIRE();
+        if (STAT_LOAD(slot->words[0]) != seq + 1) continue;
+
+        event.words[0] = seq + 1;
+        events[copied++] = event.event;
+    }
+    return copied;
+}
+#endif
+
+#undef DEBUG_PRINT
+#undef DEBUG_PRINT_HEX
+#undef LOAD_ACQUIRE
+#undef STORE_RELEASE
+#undef STAT_ADD
+#undef STAT_STORE
+#undef STAT_LOAD
+#undef TRACE
+#undef TRACE_PARTS
+#ifdef CWAKE_TRACE
+#undef TRACE_CLAIM
+#undef TRACE_FENCE_RELEASE
+#undef TRACE_FENCE_ACQUIRE
+#endif
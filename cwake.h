@@ -7,6 +7,7 @@
 
 #ifndef CWAKE_H
 #define CWAKE_H
+#include <stddef.h>
 #include <stdint.h>
 
 typedef enum cwake_error {
@@ -15,33 +16,243 @@ typedef enum cwake_error {
     CWAKE_ERROR_CRC          = -2,
     CWAKE_ERROR_INVALID_DATA = -3,
     CWAKE_ERROR_OVERFLOW     = -4,
-    CWAKE_ERROR_BUSY         = -5
+    CWAKE_ERROR_BUSY         = -5,
+    CWAKE_ERROR_IO           = -6
 } cwake_error;
 
+typedef struct cwake_iovec {
+    const uint8_t* data;
+    uint32_t       size;
+} cwake_iovec;
+
+// largest data size of one frame: classic frames carry up to 251 bytes,
+// extended frames (see cwake_frame_format) up to CWAKE_DATA_MAX (smaller
+// values limit classic frames too and shrink all frame buffers)
+#ifndef CWAKE_DATA_MAX
+#define CWAKE_DATA_MAX 251
+#endif
+#if CWAKE_DATA_MAX < 1 || CWAKE_DATA_MAX > 65535
+#error "CWAKE_DATA_MAX must be in range 1..65535"
+#endif
+
+// decoded frame without preamble (extended header and CRC-32 at most)
+#define CWAKE_FRAME_MAX (5 + CWAKE_DATA_MAX + 4)
+// encoded frame in worst case (everything but preamble is escaped)
+#define CWAKE_FRAME_ENC_MAX (1 + 2 * CWAKE_FRAME_MAX)
+
+// size of receive buffer (multiple of 64): frames are decoded in place, so
+// one decoded frame with an incomplete escape sequence behind it must fit
+#ifndef CWAKE_RX_BUFFER_SIZE
+#define CWAKE_RX_BUFFER_SIZE ((CWAKE_FRAME_MAX + 2 + 63) / 64 * 64)
+#endif
+#if CWAKE_RX_BUFFER_SIZE % 64 || CWAKE_RX_BUFFER_SIZE < CWAKE_FRAME_MAX + 2
+#error "CWAKE_RX_BUFFER_SIZE must be a multiple of 64 above CWAKE_FRAME_MAX + 1"
+#endif
+
+// size of transmit queue (power of two, holds an encoded frame at least;
+// 0: no queue, write callback must accept whole frames)
+#ifndef CWAKE_TX_QUEUE_SIZE
+#define CWAKE_TX_QUEUE_SIZE 1024
+#endif
+#if CWAKE_TX_QUEUE_SIZE && CWAKE_TX_QUEUE_SIZE < CWAKE_FRAME_ENC_MAX
+#error "CWAKE_TX_QUEUE_SIZE must hold an encoded frame of CWAKE_DATA_MAX bytes"
+#endif
+
+// full-duplex mode (see cwake_poll_tx), 0 leaves out the response handoff
+// slot (an encoded frame) of every platform
+#ifndef CWAKE_FULL_DUPLEX
+#define CWAKE_FULL_DUPLEX 1
+#endif
+
+// number of commands with registered handlers (0: no dispatch table,
+// every frame goes to platform handle)
+#ifndef CWAKE_HANDLERS
+#define CWAKE_HANDLERS 16
+#endif
+#if CWAKE_HANDLERS < 0 || CWAKE_HANDLERS > 255
+#error "CWAKE_HANDLERS must be in range 0..255"
+#endif
+
+// Frame formats. Classic WAKE frame: FEND, ADDR, CMD, N, DATA, CRC-8.
+// Extended frame has a flag byte in place of N (0xFE: CRC-16/CCITT-FALSE,
+// 0xFF: CRC-32), 16-bit length (LE), DATA and CRC (LE) of the whole frame.
+// Classic receivers reject such N as invalid.
+typedef enum cwake_frame_format {
+    CWAKE_FRAME_CLASSIC = 0,
+    CWAKE_FRAME_CRC16,
+    CWAKE_FRAME_CRC32
+} cwake_frame_format;
+
+// number of async calls in flight per platform
+#ifndef CWAKE_PENDING_MAX
+#define CWAKE_PENDING_MAX 8
+#endif
+
+// completion of async call: response data or error (CWAKE_ERROR_TIMEOUT)
+typedef void (*cwake_done)(void* ctx, cwake_error err, const uint8_t* data, uint16_t size);
+
+struct cwake_pending {
+    cwake_done on_done;                 // NULL if entry is free
+    void*      ctx;
+    uint32_t   deadline;                // ms (platform time)
+    uint8_t    addr;                    // response key
+    uint8_t    cmd;
+};
+
+// command handler, same contract as platform handle callback
+typedef int32_t (*cwake_handler)(void* ctx, uint8_t cmd,
+                                 uint8_t* data, uint16_t size,
+                                 uint8_t** rdata, uint16_t* rsize);
+
+struct cwake_handler_entry {
+    cwake_handler fn;                   // NULL: platform handle is called
+    void*         ctx;
+    uint16_t      max_response;         // 0: handler returns own buffer
+};
+
+// number of log-scale histogram buckets: bucket 0 counts times below 1 us,
+// bucket N times of 2^(N-1) .. 2^N - 1 us, the last one all longer times
+#ifndef CWAKE_STATS_BUCKETS
+#define CWAKE_STATS_BUCKETS 16
+#endif
+
+// Runtime statistics. Counters wrap around (differences of two snapshots
+// stay valid), times need the optional current_time_us callback.
+struct cwake_rx_stats {
+    uint32_t frames;                    // frames with valid crc
+    uint32_t bytes;                     // bytes read from port
+    uint32_t escapes;                   // escape sequences decoded
+    uint32_t filtered;                  // frames to other addresses
+    uint32_t crc_errors;
+    uint32_t timeouts;                  // incomplete frames dropped by timeout
+    uint32_t invalid;                   // frames of invalid format or size
+    uint32_t handled;                   // frames passed to handlers
+    uint32_t handler_us;                // total handler time
+    uint32_t handler_hist[CWAKE_STATS_BUCKETS]; // handler time
+    uint32_t turnaround_hist[CWAKE_STATS_BUCKETS]; // last read to response sent
+};
+
+struct cwake_tx_stats {
+    uint32_t frames;                    // frames written or queued
+    uint32_t bytes;                     // encoded bytes of frames
+    uint32_t escapes;                   // escape sequences encoded
+    uint32_t busy;                      // frames refused (transmit queue is full)
+};
+
+typedef struct cwake_stats {
+    struct cwake_rx_stats rx;
+    struct cwake_tx_stats tx;
+} cwake_stats;
+
+#ifdef CWAKE_TRACE
+// number of events kept in trace ring of platform (power of two)
+#ifndef CWAKE_TRACE_EVENTS
+#define CWAKE_TRACE_EVENTS 256
+#endif
+#if CWAKE_TRACE_EVENTS & (CWAKE_TRACE_EVENTS - 1)
+#error "CWAKE_TRACE_EVENTS must be a power of two"
+#endif
+
+// data bytes stored per event (longer data is cut, its size is kept)
+#ifndef CWAKE_TRACE_BYTES
+#define CWAKE_TRACE_BYTES 16
+#endif
+
+typedef enum cwake_trace_stage {
+    CWAKE_TRACE_RX = 1,                 // chunk read from port
+    CWAKE_TRACE_FRAME,                  // decoded frame with valid crc (from ADDR)
+    CWAKE_TRACE_TX,                     // encoded frame written or queued
+    CWAKE_TRACE_ERROR                   // receive error or frame refused by transmitter
+} cwake_trace_stage;
+
+// Binary trace event. A dump is an array of events (see cwake_trace_dump),
+// it is decoded offline by cwake_trace_decode built with the same options.
+typedef struct cwake_trace_event {
+    uint32_t seq;                       // event number + 1 (0 while slot is written)
+    uint32_t time_us;                   // current_time_us or current_time_ms * 1000
+    uint32_t size;                      // size of traced data
+    uint8_t  stage;                     // cwake_trace_stage
+    int8_t   code;                      // cwake_error of CWAKE_TRACE_ERROR
+    uint8_t  data[CWAKE_TRACE_BYTES];   // first bytes of data
+} cwake_trace_event;
+
+// ring slot is copied by 32-bit words, so it can be read while written
+union cwake_trace_slot {
+    cwake_trace_event event;
+    uint32_t words[sizeof(cwake_trace_event) / 4];
+};
+
+struct cwake_trace {
+    uint32_t head;                      // events claimed (sequence counter)
+    union cwake_trace_slot slots[CWAKE_TRACE_EVENTS];
+};
+#endif
+
+// Receiver and transmitter state are kept apart (small fields at the far
+// ends, buffers between them), so in full-duplex mode the two threads do
+// not share cache lines.
 struct cwake_service {
+    //receiver (cwake_poll)
     uint32_t start_pending_time;
-    //new line buffers
-    uint8_t buffer_rxenc[256*2];    // encoded received data (raw)
-    uint8_t buffer_rxdec[256];      // decoded received data
-    uint8_t buffer_txenc[256*2];    // encoded transmitting data
-    uint8_t buffer_txdec[256];      // decoded transmitting data (raw)
-    //uint8_t* buffer_rxenc_fstart;    //
-    uint8_t* buffer_rxenc_dstart;       // stored data start
-    uint8_t* buffer_rxenc_dend;         // stored data end
-    uint8_t* buffer_rxdec_dend;         // stored data end
-
-    uint8_t uncomplete_fesc_is_reserved;
+    uint32_t rx_parsed;                 // parsed bytes counter (progress)
+    uint32_t rx_head;                   // received data end
+    uint32_t rx_tail;                   // encoded data start (parse position)
+    uint32_t rx_frame;                  // decoded frame start
+    uint32_t rx_dend;                   // decoded frame end (rx_tail at most)
+    uint8_t  rx_crc;                    // crc of preamble and decoded data (CRC-8)
+    uint8_t  preamble_is_received;      // next frame preamble is parsed
+    uint8_t  rx_format;                 // cwake_frame_format of handled frame
+    uint32_t rx_read_us;                // time of last read (turnaround start)
+    struct cwake_rx_stats rx_stats;
+    uint64_t fend_map[CWAKE_RX_BUFFER_SIZE/64]; // FEND positions in buffer_rx
+    uint8_t  buffer_rx[CWAKE_RX_BUFFER_SIZE]; // received data, decoded in place
+    struct cwake_pending pending[CWAKE_PENDING_MAX]; // async calls (half-duplex)
+    uint32_t pending_count;
+#if CWAKE_HANDLERS
+    uint8_t  handler_index[256];        // handlers entry + 1 by command (0: none)
+    struct cwake_handler_entry handlers[CWAKE_HANDLERS]; // registered handlers
+    uint8_t  rx_return[CWAKE_DATA_MAX]; // prepared handler response buffer
+#endif
+
+#if CWAKE_FULL_DUPLEX
+    //handler response passed from receiver to transmitter (full-duplex)
+    uint8_t  rx_response[CWAKE_FRAME_ENC_MAX]; // encoded response frame
+    uint32_t rx_response_size;          // 0 if slot is free
+    uint32_t rx_response_escapes;       // escape sequences of response frame
+#endif
+
+    //transmitter (cwake_call, cwake_poll_tx)
+    uint8_t buffer_txenc[CWAKE_FRAME_ENC_MAX]; // encoded transmitting data
+#if CWAKE_TX_QUEUE_SIZE
+    uint8_t  tx_queue[CWAKE_TX_QUEUE_SIZE]; // data not accepted by write yet (ring)
+#endif
+    uint32_t tx_queue_head;             // ring write counter
+    uint32_t tx_queue_tail;             // ring write-out counter
+    uint8_t* batch_buffer;              // transmit batch (NULL if not active)
+    uint32_t batch_size;
+    uint32_t batch_tail;
+    struct cwake_tx_stats tx_stats;
+
+#ifdef CWAKE_TRACE
+    //trace ring (written by both sides)
+    struct cwake_trace trace;
+#endif
 };
 
 typedef struct cwake_platform {
     uint8_t     addr;
     uint32_t    timeout_ms;
-    uint32_t     (*read) (uint8_t* buf, uint32_t count);
-    uint32_t     (*write) (uint8_t* buf, uint32_t count);
-    uint32_t    (*current_time_ms) ();
-    int32_t     (*handle) (uint8_t cmd,
-                           uint8_t* data, uint8_t size,
-                           uint8_t** rdata, uint8_t* rsize
+    uint8_t     full_duplex;            // receive and transmit on own threads
+    uint8_t     frame_format;           // cwake_frame_format of transmitted frames
+    void*       user;                   // user context, passed to callbacks
+    uint32_t     (*read) (void* user, uint8_t* buf, uint32_t count);
+    uint32_t     (*write) (void* user, uint8_t* buf, uint32_t count);
+    uint32_t     (*writev) (void* user, const cwake_iovec* parts, uint32_t count); // optional
+    uint32_t    (*current_time_ms) (void* user);
+    uint32_t    (*current_time_us) (void* user); // optional, enables stats times
+    int32_t     (*handle) (void* user, uint8_t cmd,
+                           uint8_t* data, uint16_t size,
+                           uint8_t** rdata, uint16_t* rsize
                            );
     struct cwake_service service;
 } cwake_platform;
@@ -51,10 +262,34 @@ typedef struct cwake_platform {
  * @brief Initialize cWAKE protocol platform
  *
  * @param platform Pointer to cwake_platform structure object
- * @return cwake_error Error code (CWAKE_ERROR_NONE == 0).
+ * @return cwake_error Error code (CWAKE_ERROR_INVALID_DATA if full_duplex
+ *         is set and CWAKE_FULL_DUPLEX is 0).
  */
 cwake_error cwake_init(cwake_platform* platform);
 
+/**
+ * @brief Register handler of one command
+ *
+ * Frames with this command are passed to fn instead of platform handle
+ * (which stays the default for other commands and may be NULL if every
+ * received command is registered). With max_response set, *rdata points
+ * to a prepared buffer of max_response bytes when fn is called, so the
+ * response can be written in place. Up to CWAKE_HANDLERS commands can be
+ * registered at once. Call after cwake_init.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @param cmd Command code
+ * @param fn Handler (NULL to restore platform handle)
+ * @param ctx User context passed to fn
+ * @param max_response Maximum response size of handler
+ * @return cwake_error Error code (CWAKE_ERROR_INVALID_DATA if max_response
+ *         does not fit a frame, CWAKE_ERROR_BUSY if CWAKE_HANDLERS commands
+ *         are registered already).
+ */
+cwake_error cwake_register_handler(cwake_platform* platform, uint8_t cmd,
+                                   cwake_handler fn, void* ctx,
+                                   uint16_t max_response);
+
 /**
  * @brief Polling data transfer interface (using read/write callbacks)
  *
@@ -63,21 +298,228 @@ cwake_error cwake_init(cwake_platform* platform);
  */
 cwake_error cwake_poll(cwake_platform* platform);
 
+/**
+ * @brief Transmitter polling in full-duplex mode
+ *
+ * With platform full_duplex set, cwake_poll only receives (read callback)
+ * and handler responses are passed to the transmitter, while cwake_poll_tx
+ * and cwake_call only transmit (write callbacks). Receiver and transmitter
+ * may then run on two threads without locks. cwake_poll_tx writes queued
+ * data and the pending handler response; until the response is taken,
+ * cwake_poll returns CWAKE_ERROR_BUSY without receiving.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if transmit queue is full).
+ */
+cwake_error cwake_poll_tx(cwake_platform* platform);
+
+/**
+ * @brief Polling data transfer interface, handles all buffered frames
+ *
+ * Like cwake_poll, but decodes and handles every complete frame of the
+ * received data in one call (read callback is called once at most).
+ * Stops on the first error, remaining frames are handled on next call.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @param max_frames Maximum number of frames to handle
+ * @param handled Pointer to number of handled frames (can be NULL)
+ * @return cwake_error Error code (CWAKE_ERROR_NONE == 0).
+ */
+cwake_error cwake_poll_batch(cwake_platform* platform,
+                             uint32_t max_frames, uint32_t* handled);
+
 /**
  * @brief Send command with potential data to server
  *
+ * Frame is sent in frame_format of platform: classic frames carry up to
+ * 251 bytes, extended frames up to CWAKE_DATA_MAX bytes. Received frames
+ * of any format are accepted, handler responses go in the format of the
+ * request if it is extended.
+ *
  * @param addr Server address
  * @param cmd Command code
  * @param data Pointer to data
  * @param size Size of data array
  * @param platform Pointer to cwake_platform structure object
- * @return cwake_error Error code (CWAKE_ERROR_NONE == 0).
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if transmit queue is full,
+ *         CWAKE_ERROR_INVALID_DATA if data does not fit a frame,
+ *         CWAKE_ERROR_IO if frame was written partly and there is no
+ *         transmit queue).
  */
 cwake_error cwake_call(uint8_t addr, uint8_t cmd,
-                       uint8_t* data, uint8_t size,
+                       uint8_t* data, uint16_t size,
                        cwake_platform* platform);
 
+/**
+ * @brief Send command and wait for response without blocking
+ *
+ * Call is kept in pending table of platform until response with the same
+ * address and command is received by cwake_poll (on_done gets its data,
+ * handle callback is not called) or timeout expires (on_done gets
+ * CWAKE_ERROR_TIMEOUT). Only one call per (addr, cmd) is in flight, calls
+ * to different slaves or commands are pipelined. Half-duplex mode only.
+ *
+ * @param addr Server address
+ * @param cmd Command code
+ * @param data Pointer to data
+ * @param size Size of data array
+ * @param on_done Completion callback, called once from cwake_poll
+ * @param ctx User context for on_done
+ * @param timeout_ms Response timeout in ms
+ * @param platform Pointer to cwake_platform structure object
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if the same call is in
+ *         flight, pending table or transmit queue is full).
+ */
+cwake_error cwake_call_async(uint8_t addr, uint8_t cmd,
+                             uint8_t* data, uint16_t size,
+                             cwake_done on_done, void* ctx, uint32_t timeout_ms,
+                             cwake_platform* platform);
+
+/**
+ * @brief Send command with data gathered from several parts
+ *
+ * Parts are encoded straight from their memory, in order, as one frame.
+ * If platform writev callback is set, the frame is passed to it as a list
+ * of segments (escape-free parts are referenced in place), otherwise it is
+ * encoded into one buffer and passed to write callback.
+ *
+ * @param addr Server address
+ * @param cmd Command code
+ * @param parts Array of data parts
+ * @param count Number of parts
+ * @param platform Pointer to cwake_platform structure object
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if transmit queue is full).
+ */
+cwake_error cwake_callv(uint8_t addr, uint8_t cmd,
+                        const cwake_iovec* parts, uint32_t count,
+                        cwake_platform* platform);
+
+/**
+ * @brief Send response to a request after its handler has returned
+ *
+ * Response is sent from platform address in the format of the request
+ * (service rx_format while the handler runs), a classic request is answered
+ * in platform frame_format, as handler responses are.
+ *
+ * @param cmd Command code
+ * @param data Pointer to data
+ * @param size Size of data array
+ * @param format cwake_frame_format of the request
+ * @param platform Pointer to cwake_platform structure object
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if transmit queue is full,
+ *         CWAKE_ERROR_INVALID_DATA if data does not fit a frame).
+ */
+cwake_error cwake_respond(uint8_t cmd, const uint8_t* data, uint16_t size,
+                          uint8_t format, cwake_platform* platform);
+/**
+ * @brief Start collecting transmitted frames into one buffer
+ *
+ * Frames sent by cwake_call/cwake_callv (and handler responses) are encoded
+ * back to back into the buffer instead of being written one by one.
+ * The buffer is written when the worst-case encoded size of the next frame
+ * (1 + 2 * (size + 4) bytes, 1 + 2 * (size + 9) for extended frames) does
+ * not fit into its free space and by
+ * cwake_batch_flush; frames larger than the whole buffer are written directly.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @param buffer Batch buffer, must stay valid until cwake_batch_flush
+ * @param size Size of batch buffer
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if batch is active).
+ */
+cwake_error cwake_batch_begin(cwake_platform* platform,
+                              uint8_t* buffer, uint32_t size);
+
+/**
+ * @brief Write collected frames with one write call and stop batching
+ *
+ * If the port does not accept all frames and the rest does not fit into
+ * transmit queue, the rest stays in batch buffer and batching goes on.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if data is left in batch).
+ */
+cwake_error cwake_batch_flush(cwake_platform* platform);
+
+/**
+ * @brief Get size of transmit data waiting in queue
+ *
+ * Write callback may accept less data than offered (non-blocking port),
+ * the rest is queued and written by next cwake_poll/cwake_call calls.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @return uint32_t Number of queued bytes (0 if all data is written).
+ */
+uint32_t cwake_tx_pending(const cwake_platform* platform);
+
+/**
+ * @brief Copy runtime statistics of platform
+ *
+ * Counters are read one by one without locks, so it can be called from any
+ * thread while the platform is polled (counters of one snapshot may belong
+ * to slightly different moments).
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @param stats Pointer to snapshot
+ */
+void cwake_stats_snapshot(const cwake_platform* platform, cwake_stats* stats);
+
+/**
+ * @brief Clear runtime statistics of platform
+ *
+ * Call from the thread polling the platform (in full-duplex mode while
+ * neither side is polled), or compare snapshots instead.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ */
+void cwake_stats_reset(cwake_platform* platform);
 
+#ifdef CWAKE_TRACE
+/**
+ * @brief Copy latest trace events of platform, oldest first
+ *
+ * Can be called from any thread while the platform is polled: events
+ * overwritten during the copy are left out, so numbers (seq) may have gaps.
+ *
+ * @param platform Pointer to cwake_platform structure object
+ * @param events Pointer to array of events
+ * @param max Size of events array (CWAKE_TRACE_EVENTS holds the whole ring)
+ * @return uint32_t Number of copied events
+ */
+uint32_t cwake_trace_dump(const cwake_platform* platform, cwake_trace_event* events, uint32_t max);
+#endif
+
+/**
+ * @brief Calculate WAKE CRC-8 (polynomial 0x31) of data
+ *
+ * Can be chained: crc of concatenated arrays is
+ * cwake_crc8(b, b_size, cwake_crc8(a, a_size, 0)).
+ *
+ * @param data Pointer to data
+ * @param size Size of data array
+ * @param crc Initial crc value (0 for new calculation)
+ * @return uint8_t CRC-8 value
+ */
+uint8_t cwake_crc8(const uint8_t* data, size_t size, uint8_t crc);
+
+/**
+ * @brief Calculate CRC-16/CCITT-FALSE of data (extended frames)
+ *
+ * @param data Pointer to data
+ * @param size Size of data array
+ * @param crc Initial crc value (0xFFFF for new calculation)
+ * @return uint16_t CRC-16 value
+ */
+uint16_t cwake_crc16(const uint8_t* data, size_t size, uint16_t crc);
+
+/**
+ * @brief Calculate CRC-32 (IEEE 802.3, as zlib) of data (extended frames)
+ *
+ * @param data Pointer to data
+ * @param size Size of data array
+ * @param crc Previous crc value (0 for new calculation)
+ * @return uint32_t CRC-32 value
+ */
+uint32_t cwake_crc32(const uint8_t* data, size_t size, uint32_t crc);
 
 //make internal implementations public for test
 #ifdef CWAKE_TEST
@@ -89,13 +531,15 @@ extern const uint8_t TFEND;
 extern const uint8_t TFESC;
 extern const uint8_t PREAMBLE;
 extern const uint8_t CRC8_POLYNOMIAL;
+extern const uint8_t EXT_FLAG_CRC16;
+extern const uint8_t EXT_FLAG_CRC32;
 
 // sizes
-extern const size_t WORK_BUFFER_SIZE;
-extern const size_t STUFFER_BUFFER_SIZE;
 extern const size_t PREAMBLE_SIZE;
 extern const size_t HEADER_SIZE;
 extern const size_t CRC_SIZE;
+extern const size_t CLASSIC_DATA_MAX;
+extern const size_t EXT_HEADER_SIZE;
 
 // positions
 extern const int16_t PREAMBLE_POS; // !!! PREAMBLE is not saved in buffer
@@ -104,13 +548,31 @@ extern const int16_t CMD_POS;
 extern const int16_t SIZE_POS;
 extern const int16_t DATA_POS;
 
+// scatter-gather transmit
+extern const size_t GATHER_PART_MIN_SIZE;
+
+// kernels
+extern const int KERNEL_SCALAR;
+extern const int KERNEL_SSE2;
+extern const int KERNEL_AVX2;
+
 void reset_buffers(cwake_platform* platform);
 void reset_state(cwake_platform* platform);
 uint8_t is_timeout(cwake_platform* platform);
-void generate_crc8_table(uint8_t polynomial);
-uint8_t get_crc8(uint8_t* data, uint8_t size, uint8_t crc);
+uint8_t get_crc8(const uint8_t* data, size_t size, uint8_t crc);
+uint16_t get_crc16(const uint8_t* data, size_t size, uint16_t crc);
+uint32_t get_crc32(const uint8_t* data, size_t size, uint32_t crc);
+int select_kernels(int max_kernel);
+size_t stuff_scalar(const uint8_t* src, size_t src_len, uint8_t* dst);
 size_t stuff(const uint8_t* src, uint8_t src_len, uint8_t* dst);
+void scan_fend_scalar(const uint8_t* buf, size_t pos, size_t size, uint64_t* map);
+void scan_fend(const uint8_t* buf, size_t pos, size_t size, uint64_t* map);
+size_t find_fend(const uint64_t* map, size_t pos, size_t count);
+size_t stuff_crc8(const uint8_t* src, size_t src_len, uint8_t* dst, uint8_t* crc);
+size_t destuff_scalar(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_max_len);
 size_t destuff(const uint8_t* src, size_t src_len, uint8_t* dst, size_t dst_max_len);
+size_t destuff_crc8(const uint8_t* src, size_t src_len,
+                    uint8_t* dst, size_t dst_max_len, uint8_t* crc);
 cwake_error read_and_destuff(cwake_platform* platform);
 
 #endif
@@ -0,0 +1,204 @@
+/**
+ * @file cwake_bulk.c
+ * @brief CWAKE bulk transfer of buffers larger than one frame
+ * @author Qvafir <qvafir@outlook.com>
+ * @copyright MIT License, see repository LICENSE file
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "cwake_bulk.h"
+
+// frame payload: type, transfer id, sequence number (LE), fragment data
+enum {
+    BULK_DATA = 0x01,
+    BULK_DATA_LAST = 0x02,
+    BULK_ACK = 0x03
+};
+
+#define BULK_HEADER_SIZE 4
+
+// ================================================================= Receiver
+static uint8_t receive(cwake_bulk* bulk, uint8_t type, uint8_t id, uint32_t seq,
+                       const uint8_t* data, uint16_t size)
+{
+    if (!bulk->rx_buffer) return 0;
+    // only the last fragment may be short (offsets are seq * fragment)
+    if (size > CWAKE_BULK_FRAGMENT || (type == BULK_DATA && size != CWAKE_BULK_FRAGMENT)) {
+        return 0;
+    }
+
+    // new transfer starts by its first fragment only; first fragment after
+    // a completed transfer starts a new one even with the same id (sender
+    // restarted), a completed transfer whose acknowledges were all lost is
+    // received again
+    if (id != bulk->rx_id || (bulk->rx_complete && seq == 0)) {
+        if (seq != 0) return 0;
+        bulk->rx_id = id;
+        bulk->rx_next = 0;
+        bulk->rx_complete = 0;
+    }
+    // fragments after a lost one and repeated ones are only acknowledged
+    if (bulk->rx_complete || seq != bulk->rx_next) return 1;
+
+    uint32_t offset = seq * CWAKE_BULK_FRAGMENT;
+    if (offset + size > bulk->rx_capacity) return 0;
+    memcpy(bulk->rx_buffer + offset, data, size);
+    bulk->rx_next += 1;
+
+    if (type == BULK_DATA_LAST) {
+        bulk->rx_complete = 1;
+        if (bulk->on_received) bulk->on_received(bulk->ctx, bulk->rx_buffer, offset + size);
+    }
+    return 1;
+}
+
+// =================================================================== Sender
+static void acknowledge(cwake_bulk* bulk, uint8_t id, uint32_t next)
+{
+    if (bulk->tx_status != CWAKE_ERROR_BUSY || id != bulk->tx_id) return;
+    // acknowledge is cumulative, old and repeated ones are ignored
+    if (next <= bulk->tx_base || next > bulk->tx_count) return;
+
+    // may come after going back, for fragments sent before
+    bulk->tx_base = next;
+    if (bulk->tx_next < next) bulk->tx_next = next;
+    bulk->tx_retries = 0;
+    bulk->tx_progress_ms = bulk->platform->current_time_ms(bulk->platform->user);
+    if (bulk->tx_base == bulk->tx_count) {
+        bulk->tx_time_ms = bulk->tx_progress_ms - bulk->tx_start_ms;
+        bulk->tx_status = CWAKE_ERROR_NONE;
+    }
+}
+
+static cwake_error send_fragment(cwake_bulk* bulk, uint32_t seq)
+{
+    uint8_t frame[BULK_HEADER_SIZE + CWAKE_BULK_FRAGMENT];
+    uint32_t offset = seq * CWAKE_BULK_FRAGMENT;
+    uint32_t size = bulk->tx_size - offset;
+
+    if (size > CWAKE_BULK_FRAGMENT) size = CWAKE_BULK_FRAGMENT;
+    frame[0] = seq + 1 == bulk->tx_count ? BULK_DATA_LAST : BULK_DATA;
+    frame[1] = bulk->tx_id;
+    frame[2] = seq & 0xFF;
+    frame[3] = seq >> 8;
+    memcpy(frame + BULK_HEADER_SIZE, bulk->tx_data + offset, size);
+    return cwake_call(bulk->tx_addr, bulk->cmd, frame, BULK_HEADER_SIZE + size, bulk->platform);
+}
+
+// handler of bulk command on both sides
+static int32_t handle(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                      uint8_t** rdata, uint16_t* rsize)
+{
+    cwake_bulk* bulk = ctx;
+
+    if (size < BULK_HEADER_SIZE) return -1;
+    uint8_t type = data[0];
+    uint8_t id = data[1];
+    uint32_t seq = data[2] | (uint32_t)data[3] << 8;
+
+    if (type == BULK_ACK) {
+        acknowledge(bulk, id, seq);
+        return 0;
+    }
+    if (type != BULK_DATA && type != BULK_DATA_LAST) return -1;
+    if (!receive(bulk, type, id, seq, data + BULK_HEADER_SIZE, size - BULK_HEADER_SIZE)) {
+        return -1;
+    }
+
+    // acknowledge into prepared response buffer
+    uint8_t* ack = *rdata;
+    ack[0] = BULK_ACK;
+    ack[1] = bulk->rx_id;
+    ack[2] = bulk->rx_next & 0xFF;
+    ack[3] = bulk->rx_next >> 8;
+    *rsize = BULK_HEADER_SIZE;
+    return 0;
+}
+
+// ========================================================== Public functional
+cwake_error cwake_bulk_init(cwake_bulk* bulk, cwake_platform* platform,
+                            uint8_t cmd, uint32_t timeout_ms)
+{
+    memset(bulk, 0, sizeof(*bulk));
+    bulk->platform = platform;
+    bulk->cmd = cmd;
+    bulk->timeout_ms = timeout_ms;
+    bulk->window = CWAKE_BULK_WINDOW;
+    bulk->tx_status = CWAKE_ERROR_NONE;
+    return cwake_register_handler(platform, cmd, handle, bulk, BULK_HEADER_SIZE);
+}
+
+void cwake_bulk_listen(cwake_bulk* bulk, uint8_t* buffer, uint32_t capacity,
+                       cwake_bulk_received on_received, void* ctx)
+{
+    bulk->rx_buffer = buffer;
+    bulk->rx_capacity = capacity;
+    bulk->on_received = on_received;
+    bulk->ctx = ctx;
+}
+
+cwake_error cwake_bulk_send(cwake_bulk* bulk, uint8_t addr,
+                            const uint8_t* data, uint32_t size)
+{
+    uint32_t count = (size + CWAKE_BULK_FRAGMENT - 1) / CWAKE_BULK_FRAGMENT;
+
+    if (bulk->tx_status == CWAKE_ERROR_BUSY) return CWAKE_ERROR_BUSY;
+    if (count == 0 || count > 0xFFFF) return CWAKE_ERROR_INVALID_DATA;
+
+    bulk->tx_data = data;
+    bulk->tx_size = size;
+    bulk->tx_count = count;
+    bulk->tx_base = 0;
+    bulk->tx_next = 0;
+    bulk->tx_retries = 0;
+    bulk->tx_resent = 0;
+    bulk->tx_addr = addr;
+    bulk->tx_id = bulk->tx_id == 0xFF ? 1 : bulk->tx_id + 1;    // 0: no transfer
+    bulk->tx_start_ms = bulk->platform->current_time_ms(bulk->platform->user);
+    bulk->tx_progress_ms = bulk->tx_start_ms;
+    bulk->tx_status = CWAKE_ERROR_BUSY;
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_bulk_poll(cwake_bulk* bulk)
+{
+    if (bulk->tx_status != CWAKE_ERROR_BUSY) return bulk->tx_status;
+
+    // go back to first unacknowledged fragment
+    uint32_t now = bulk->platform->current_time_ms(bulk->platform->user);
+    if (bulk->tx_next != bulk->tx_base && now - bulk->tx_progress_ms >= bulk->timeout_ms) {
+        if (bulk->tx_retries == CWAKE_BULK_RETRIES) {
+            bulk->tx_status = CWAKE_ERROR_TIMEOUT;
+            return bulk->tx_status;
+        }
+        bulk->tx_retries += 1;
+        bulk->tx_resent += bulk->tx_next - bulk->tx_base;
+        bulk->tx_next = bulk->tx_base;
+        bulk->tx_progress_ms = now;
+    }
+
+    // fill window while transmit queue takes fragments
+    uint32_t window = bulk->window ? bulk->window : 1;
+    if (window > CWAKE_BULK_WINDOW) window = CWAKE_BULK_WINDOW;
+    while (bulk->tx_next < bulk->tx_count && bulk->tx_next - bulk->tx_base < window) {
+        cwake_error err = send_fragment(bulk, bulk->tx_next);
+        if (err == CWAKE_ERROR_BUSY) break;
+        // fragment will never be taken
+        if (err) {
+            bulk->tx_status = err;
+            return err;
+        }
+        if (bulk->tx_next == bulk->tx_base) bulk->tx_progress_ms = now;
+        bulk->tx_next += 1;
+    }
+    return bulk->tx_status;
+}
+
+uint32_t cwake_bulk_goodput(const cwake_bulk* bulk)
+{
+    if (bulk->tx_status != CWAKE_ERROR_NONE || bulk->tx_size == 0) return 0;
+    uint32_t time_ms = bulk->tx_time_ms ? bulk->tx_time_ms : 1;
+    return (uint64_t)bulk->tx_size * 1000 / time_ms;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file cwake_bulk.h
+ * @brief CWAKE bulk transfer of buffers larger than one frame
+ * @author Qvafir <qvafir@outlook.com>
+ * @copyright MIT License, see repository LICENSE file
+ */
+
+#ifndef CWAKE_BULK_H
+#define CWAKE_BULK_H
+#include <stdint.h>
+
+#include "cwake.h"
+
+// data bytes per fragment (frame payload without 4 bytes of bulk header: at
+// most 247, CWAKE_DATA_MAX - 4 if platform sends extended frames)
+#ifndef CWAKE_BULK_FRAGMENT
+#if CWAKE_DATA_MAX < 251
+#define CWAKE_BULK_FRAGMENT (CWAKE_DATA_MAX - 4)
+#else
+#define CWAKE_BULK_FRAGMENT 247
+#endif
+#endif
+#if CWAKE_BULK_FRAGMENT < 1 || CWAKE_BULK_FRAGMENT + 4 > CWAKE_DATA_MAX
+#error "CWAKE_BULK_FRAGMENT with bulk header must fit CWAKE_DATA_MAX"
+#endif
+
+// maximum number of fragments sent and not acknowledged yet
+#ifndef CWAKE_BULK_WINDOW
+#define CWAKE_BULK_WINDOW 8
+#endif
+
+// retransmissions of window without acknowledge before transfer fails
+#ifndef CWAKE_BULK_RETRIES
+#define CWAKE_BULK_RETRIES 5
+#endif
+
+// completion of received transfer
+typedef void (*cwake_bulk_received)(void* ctx, const uint8_t* data, uint32_t size);
+
+typedef struct cwake_bulk {
+    cwake_platform* platform;
+    uint8_t         cmd;                // command of fragments and acknowledges
+    uint32_t        timeout_ms;         // retransmission timeout
+    uint32_t        window;             // fragments in flight (1 .. CWAKE_BULK_WINDOW)
+
+    //sender
+    const uint8_t*  tx_data;
+    uint32_t        tx_size;
+    uint32_t        tx_count;           // number of fragments
+    uint32_t        tx_base;            // first fragment not acknowledged
+    uint32_t        tx_next;            // next fragment to send
+    uint32_t        tx_progress_ms;     // time of last sending or acknowledge
+    uint32_t        tx_start_ms;
+    uint32_t        tx_time_ms;         // duration of last completed transfer
+    uint32_t        tx_retries;
+    uint32_t        tx_resent;          // fragments sent again (statistics)
+    cwake_error     tx_status;          // CWAKE_ERROR_BUSY while sending
+    uint8_t         tx_addr;
+    uint8_t         tx_id;              // transfer id
+
+    //receiver
+    uint8_t*        rx_buffer;          // NULL: receiving is disabled
+    uint32_t        rx_capacity;
+    uint32_t        rx_next;            // next expected fragment
+    uint8_t         rx_id;
+    uint8_t         rx_complete;        // last fragment of rx_id is received
+    cwake_bulk_received on_received;
+    void*           ctx;
+} cwake_bulk;
+
+/**
+ * @brief Initialize bulk transfer over one command of platform
+ *
+ * Registers a handler of cmd (see cwake_register_handler), which receives
+ * fragments and acknowledges on both sides of the link. Fragments carry
+ * a transfer id and a sequence number; the receiver acknowledges the next
+ * expected fragment, the sender keeps up to window fragments in flight
+ * and sends them again from the first unacknowledged one on timeout.
+ * Acknowledges are responses, so the sender is the master (address 0).
+ *
+ * @param bulk Pointer to cwake_bulk structure object
+ * @param platform Initialized platform
+ * @param cmd Command code used by bulk transfer
+ * @param timeout_ms Retransmission timeout in ms
+ * @return cwake_error Error code (CWAKE_ERROR_NONE == 0).
+ */
+cwake_error cwake_bulk_init(cwake_bulk* bulk, cwake_platform* platform,
+                            uint8_t cmd, uint32_t timeout_ms);
+
+/**
+ * @brief Enable receiving of transfers into buffer
+ *
+ * @param bulk Pointer to cwake_bulk structure object
+ * @param buffer Reassembly buffer, passed to on_received on completion
+ * @param capacity Size of buffer (larger transfers are not acknowledged)
+ * @param on_received Completion callback, called from cwake_poll
+ * @param ctx User context for on_received
+ */
+void cwake_bulk_listen(cwake_bulk* bulk, uint8_t* buffer, uint32_t capacity,
+                       cwake_bulk_received on_received, void* ctx);
+
+/**
+ * @brief Start sending buffer (data must stay valid until transfer ends)
+ *
+ * @param bulk Pointer to cwake_bulk structure object
+ * @param addr Receiver address
+ * @param data Pointer to data
+ * @param size Size of data (up to 65535 fragments)
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if a transfer is active).
+ */
+cwake_error cwake_bulk_send(cwake_bulk* bulk, uint8_t addr,
+                            const uint8_t* data, uint32_t size);
+
+/**
+ * @brief Send fragments of window and check retransmission timeout
+ *
+ * Call together with cwake_poll, which delivers acknowledges.
+ *
+ * @param bulk Pointer to cwake_bulk structure object
+ * @return cwake_error Transfer status: CWAKE_ERROR_BUSY while sending,
+ *         CWAKE_ERROR_NONE when done, CWAKE_ERROR_TIMEOUT if failed or
+ *         error of cwake_call if a fragment cannot be sent (e.g.
+ *         CWAKE_ERROR_INVALID_DATA if it does not fit a frame).
+ */
+cwake_error cwake_bulk_poll(cwake_bulk* bulk);
+
+/**
+ * @brief Goodput of last completed transfer
+ *
+ * @param bulk Pointer to cwake_bulk structure object
+ * @return uint32_t Delivered data bytes per second (0 if none)
+ */
+uint32_t cwake_bulk_goodput(const cwake_bulk* bulk);
+
+#endif // CWAKE_BULK_H
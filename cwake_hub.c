@@ -0,0 +1,285 @@
+/**
+ * @file cwake_hub.c
+ * @brief CWAKE multi-port hub (Linux epoll)
+ * @author Qvafir <qvafir@outlook.com>
+ * @copyright MIT License, see repository LICENSE file
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "cwake_hub.h"
+
+#define HUB_EVENTS_MAX 64 // events taken by one epoll_wait call
+
+static const uint32_t HEAP_NONE = UINT32_MAX;
+
+// ============================================================ Deadline heap
+// Binary min-heap of port indices ordered by deadline. Entry of heap
+// position N is kept in ports[N].heap_item, so no storage beyond ports.
+static inline int is_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0; // ms clock may wrap
+}
+
+static inline uint32_t heap_deadline(cwake_hub* hub, uint32_t pos)
+{
+    return hub->ports[hub->ports[pos].heap_item].deadline;
+}
+
+static inline void heap_set(cwake_hub* hub, uint32_t pos, uint32_t index)
+{
+    hub->ports[pos].heap_item = index;
+    hub->ports[index].heap_pos = pos;
+}
+
+static void heap_sift_up(cwake_hub* hub, uint32_t pos)
+{
+    uint32_t index = hub->ports[pos].heap_item;
+    uint32_t deadline = hub->ports[index].deadline;
+
+    while (pos) {
+        uint32_t parent = (pos - 1) / 2;
+        if (!is_before(deadline, heap_deadline(hub, parent))) break;
+        heap_set(hub, pos, hub->ports[parent].heap_item);
+        pos = parent;
+    }
+    heap_set(hub, pos, index);
+}
+
+static void heap_sift_down(cwake_hub* hub, uint32_t pos)
+{
+    uint32_t index = hub->ports[pos].heap_item;
+    uint32_t deadline = hub->ports[index].deadline;
+
+    while (2 * pos + 1 < hub->heap_size) {
+        uint32_t child = 2 * pos + 1;
+        if (child + 1 < hub->heap_size &&
+            is_before(heap_deadline(hub, child + 1), heap_deadline(hub, child))) {
+            child += 1;
+        }
+        if (!is_before(heap_deadline(hub, child), deadline)) break;
+        heap_set(hub, pos, hub->ports[child].heap_item);
+        pos = child;
+    }
+    heap_set(hub, pos, index);
+}
+
+static void heap_remove(cwake_hub* hub, uint32_t index)
+{
+    uint32_t pos = hub->ports[index].heap_pos;
+
+    if (pos == HEAP_NONE) return;
+    hub->ports[index].heap_pos = HEAP_NONE;
+    hub->heap_size -= 1;
+    if (pos == hub->heap_size) return;
+
+    heap_set(hub, pos, hub->ports[hub->heap_size].heap_item);
+    uint32_t moved = hub->ports[pos].heap_item;
+    heap_sift_up(hub, pos);
+    heap_sift_down(hub, hub->ports[moved].heap_pos);
+}
+
+// nearest of receive timeout and async call deadlines, 0 if there is none
+static int next_deadline(const cwake_platform* platform, uint32_t* deadline)
+{
+    const struct cwake_service* ps = &platform->service;
+    int scheduled = 0;
+
+    //platform reports timeout when more than timeout_ms has passed
+    if (ps->start_pending_time) {
+        *deadline = ps->start_pending_time + platform->timeout_ms + 1;
+        scheduled = 1;
+    }
+    for (uint32_t i = 0; ps->pending_count && i < CWAKE_PENDING_MAX; i++) {
+        const struct cwake_pending* call = &ps->pending[i];
+        if (!call->on_done) continue;
+        if (!scheduled || is_before(call->deadline, *deadline)) *deadline = call->deadline;
+        scheduled = 1;
+    }
+    return scheduled;
+}
+
+// (re)schedule port by receive timeout timer and async calls of its platform
+static void schedule(cwake_hub* hub, uint32_t index)
+{
+    cwake_hub_port* port = &hub->ports[index];
+    uint32_t deadline = 0;
+
+    if (!next_deadline(port->platform, &deadline)) {
+        heap_remove(hub, index);
+        return;
+    }
+    if (port->heap_pos != HEAP_NONE && port->deadline == deadline) return;
+
+    port->deadline = deadline;
+    if (port->heap_pos == HEAP_NONE) {
+        heap_set(hub, hub->heap_size, index);
+        hub->heap_size += 1;
+    }
+    heap_sift_up(hub, port->heap_pos);
+    heap_sift_down(hub, port->heap_pos);
+}
+
+// ==================================================================== Ports
+static inline void report(cwake_hub* hub, cwake_platform* platform, cwake_error err)
+{
+    if (err && hub->error) hub->error(platform, err);
+}
+
+// wait for writable port only while it has queued transmit data
+static void watch_tx(cwake_hub* hub, uint32_t index)
+{
+    cwake_hub_port* port = &hub->ports[index];
+    uint32_t events = cwake_tx_pending(port->platform) ? EPOLLIN | EPOLLOUT : EPOLLIN;
+
+    if (events == port->events) return;
+    struct epoll_event event = { .events = events };
+    event.data.u32 = index;
+    if (epoll_ctl(hub->epoll_fd, EPOLL_CTL_MOD, port->fd, &event) == 0) port->events = events;
+}
+
+// handle all buffered frames of port, errors consume their frames
+static uint32_t serve(cwake_hub* hub, uint32_t index)
+{
+    cwake_platform* platform = hub->ports[index].platform;
+    uint32_t handled = 0;
+    cwake_error err;
+
+    do {
+        uint32_t tail = platform->service.rx_parsed;
+        uint32_t frames = 0;
+        err = cwake_poll_batch(platform, UINT32_MAX, &frames);
+        handled += frames;
+        report(hub, platform, err);
+        if (tail == platform->service.rx_parsed) break;
+    } while (err != CWAKE_ERROR_NONE);
+
+    schedule(hub, index);
+    watch_tx(hub, index);
+    return handled;
+}
+
+static uint32_t find_port(const cwake_hub* hub, const cwake_platform* platform)
+{
+    uint32_t index = 0;
+    while (index < hub->ports_count && hub->ports[index].platform != platform) index++;
+    return index;
+}
+
+// ========================================================== Public functional
+cwake_error cwake_hub_init(cwake_hub* hub, cwake_hub_port* ports, uint32_t ports_max)
+{
+    hub->ports = ports;
+    hub->ports_max = ports_max;
+    hub->ports_count = 0;
+    hub->heap_size = 0;
+    hub->error = NULL;
+    hub->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+    return hub->epoll_fd < 0 ? CWAKE_ERROR_IO : CWAKE_ERROR_NONE;
+}
+
+void cwake_hub_close(cwake_hub* hub)
+{
+    if (hub->epoll_fd >= 0) close(hub->epoll_fd);
+    hub->epoll_fd = -1;
+    hub->ports_count = 0;
+    hub->heap_size = 0;
+}
+
+cwake_error cwake_hub_add(cwake_hub* hub, cwake_platform* platform, int fd)
+{
+    if (hub->ports_count >= hub->ports_max) return CWAKE_ERROR_OVERFLOW;
+
+    uint32_t index = hub->ports_count;
+    struct epoll_event event = { .events = EPOLLIN };
+    event.data.u32 = index;
+    if (epoll_ctl(hub->epoll_fd, EPOLL_CTL_ADD, fd, &event)) return CWAKE_ERROR_IO;
+
+    hub->ports[index].platform = platform;
+    hub->ports[index].fd = fd;
+    hub->ports[index].events = EPOLLIN;
+    hub->ports[index].heap_pos = HEAP_NONE;
+    hub->ports_count += 1;
+    schedule(hub, index);
+    watch_tx(hub, index);
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_hub_watch(cwake_hub* hub, cwake_platform* platform)
+{
+    uint32_t index = find_port(hub, platform);
+    if (index == hub->ports_count) return CWAKE_ERROR_INVALID_DATA;
+
+    schedule(hub, index);
+    watch_tx(hub, index);
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_hub_remove(cwake_hub* hub, cwake_platform* platform)
+{
+    uint32_t index = find_port(hub, platform);
+    if (index == hub->ports_count) return CWAKE_ERROR_INVALID_DATA;
+
+    heap_remove(hub, index);
+    epoll_ctl(hub->epoll_fd, EPOLL_CTL_DEL, hub->ports[index].fd, NULL);
+    hub->ports_count -= 1;
+
+    // last port takes the free slot (heap_item belongs to the position)
+    uint32_t last = hub->ports_count;
+    if (index == last) return CWAKE_ERROR_NONE;
+
+    cwake_hub_port* port = &hub->ports[index];
+    port->platform = hub->ports[last].platform;
+    port->fd = hub->ports[last].fd;
+    port->events = hub->ports[last].events;
+    port->deadline = hub->ports[last].deadline;
+    port->heap_pos = hub->ports[last].heap_pos;
+    if (port->heap_pos != HEAP_NONE) hub->ports[port->heap_pos].heap_item = index;
+
+    struct epoll_event event = { .events = port->events };
+    event.data.u32 = index;
+    if (epoll_ctl(hub->epoll_fd, EPOLL_CTL_MOD, port->fd, &event)) return CWAKE_ERROR_IO;
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_hub_poll(cwake_hub* hub, int32_t wait_ms, uint32_t* handled)
+{
+    struct epoll_event events[HUB_EVENTS_MAX];
+    uint32_t frames = 0;
+
+    // ==== WAITING ====
+    // no longer than the nearest receive timeout or async call deadline
+    if (hub->heap_size) {
+        cwake_platform* platform = hub->ports[hub->ports[0].heap_item].platform;
+        int32_t left = (int32_t)(heap_deadline(hub, 0) - platform->current_time_ms(platform->user));
+        if (left < 0) left = 0;
+        if (wait_ms < 0 || left < wait_ms) wait_ms = left;
+    }
+
+    int ready = epoll_wait(hub->epoll_fd, events, HUB_EVENTS_MAX, wait_ms);
+    if (ready < 0) {
+        if (errno != EINTR) return CWAKE_ERROR_IO;
+        ready = 0;
+    }
+
+    // ==== RECEIVING ====
+    for (int i = 0; i < ready; i++) {
+        frames += serve(hub, events[i].data.u32);
+    }
+
+    // ==== TIMEOUTS ====
+    // every port is visited once, even if its timer is restarted
+    for (uint32_t expired = hub->heap_size; expired && hub->heap_size; expired--) {
+        uint32_t index = hub->ports[0].heap_item;
+        cwake_platform* platform = hub->ports[index].platform;
+        if (is_before(platform->current_time_ms(platform->user), hub->ports[index].deadline)) break;
+        frames += serve(hub, index);
+    }
+
+    if (handled) *handled = frames;
+    return CWAKE_ERROR_NONE;
+}
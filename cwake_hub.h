@@ -0,0 +1,102 @@
+/**
+ * @file cwake_hub.h
+ * @brief CWAKE multi-port hub (Linux epoll)
+ * @author Qvafir <qvafir@outlook.com>
+ * @copyright MIT License, see repository LICENSE file
+ */
+
+#ifndef CWAKE_HUB_H
+#define CWAKE_HUB_H
+#include <stdint.h>
+
+#include "cwake.h"
+
+typedef struct cwake_hub_port {
+    cwake_platform* platform;
+    int             fd;
+    uint32_t        events;     // epoll events port is waiting for
+    uint32_t        deadline;   // receive timeout or async call deadline, if scheduled
+    uint32_t        heap_pos;   // position in deadline heap, UINT32_MAX if none
+    uint32_t        heap_item;  // port index at heap position of this entry
+} cwake_hub_port;
+
+typedef struct cwake_hub {
+    int             epoll_fd;
+    cwake_hub_port* ports;      // user storage for ports_max ports
+    uint32_t        ports_max;
+    uint32_t        ports_count;
+    uint32_t        heap_size;  // number of ports waiting for a deadline
+    void          (*error) (cwake_platform* platform, cwake_error err); // optional
+} cwake_hub;
+
+/**
+ * @brief Initialize hub of ports served by one epoll instance
+ *
+ * @param hub Pointer to cwake_hub structure object
+ * @param ports Storage for ports, must stay valid while hub is used
+ * @param ports_max Number of ports in storage
+ * @return cwake_error Error code (CWAKE_ERROR_IO if epoll is not created).
+ */
+cwake_error cwake_hub_init(cwake_hub* hub, cwake_hub_port* ports, uint32_t ports_max);
+
+/**
+ * @brief Close epoll instance of hub (platforms and fds are left open)
+ *
+ * @param hub Pointer to cwake_hub structure object
+ */
+void cwake_hub_close(cwake_hub* hub);
+
+/**
+ * @brief Add port to hub
+ *
+ * Platform read callback is called when fd is readable, but also when fd
+ * becomes writable with queued transmit data and when a receive timeout or
+ * async call deadline expires, so it must not block. All platforms of one
+ * hub must share the same current_time_ms clock.
+ *
+ * @param hub Pointer to cwake_hub structure object
+ * @param platform Initialized platform of the port
+ * @param fd File descriptor which platform reads from
+ * @return cwake_error Error code (CWAKE_ERROR_OVERFLOW if hub is full).
+ */
+cwake_error cwake_hub_add(cwake_hub* hub, cwake_platform* platform, int fd);
+
+/**
+ * @brief Remove port from hub
+ *
+ * @param hub Pointer to cwake_hub structure object
+ * @param platform Platform of the port
+ * @return cwake_error Error code (CWAKE_ERROR_INVALID_DATA if not found).
+ */
+cwake_error cwake_hub_remove(cwake_hub* hub, cwake_platform* platform);
+
+/**
+ * @brief Update port after frames were sent on it outside of hub
+ *
+ * Hub watches transmit queue and deadlines of a port only when it serves
+ * the port. Call after cwake_call or cwake_call_async from user code, so
+ * that queued data is written when fd becomes writable and the async call
+ * times out in time.
+ *
+ * @param hub Pointer to cwake_hub structure object
+ * @param platform Platform of the port
+ * @return cwake_error Error code (CWAKE_ERROR_INVALID_DATA if not found).
+ */
+cwake_error cwake_hub_watch(cwake_hub* hub, cwake_platform* platform);
+
+/**
+ * @brief Wait for received data or deadlines and handle them
+ *
+ * Polls ports with readable fds (all buffered frames at once), ports
+ * whose receive timeout or async call deadline has expired and ports with
+ * queued transmit data which became writable. Errors of single ports are
+ * passed to the optional error callback and do not stop the hub.
+ *
+ * @param hub Pointer to cwake_hub structure object
+ * @param wait_ms Maximum waiting time in ms (-1 to wait for events)
+ * @param handled Pointer to number of handled frames (can be NULL)
+ * @return cwake_error Error code (CWAKE_ERROR_IO if waiting failed).
+ */
+cwake_error cwake_hub_poll(cwake_hub* hub, int32_t wait_ms, uint32_t* handled);
+
+#endif // CWAKE_HUB_H
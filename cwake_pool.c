@@ -0,0 +1,187 @@
+/**
+ * @file cwake_pool.c
+ * @brief CWAKE worker pool for slow command handlers (POSIX threads)
+ * @author Qvafir <qvafir@outlook.com>
+ * @copyright MIT License, see repository LICENSE file
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cwake_pool.h"
+
+enum {
+    JOB_FREE = 0,
+    JOB_QUEUED,     // taken by worker
+    JOB_DONE,       // response is ready
+    JOB_SENT
+};
+
+#define LOAD_ACQUIRE(var)       __atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+
+static inline cwake_job* job_at(cwake_pool* pool, uint32_t seq)
+{
+    return &pool->jobs[seq % CWAKE_POOL_JOBS];
+}
+
+// ================================================================== Workers
+// Poll thread is the only producer and publishes a job by its ticket. A
+// worker may be woken by the post of another job, so it waits for the ticket
+// of the job it has claimed (it is already set in almost every case).
+static void* worker(void* arg)
+{
+    cwake_pool* pool = arg;
+
+    while (1) {
+        while (sem_wait(&pool->ready) && errno == EINTR) {}
+        if (LOAD_ACQUIRE(pool->stop)) return NULL;
+
+        uint32_t seq = __atomic_fetch_add(&pool->claim, 1, __ATOMIC_RELAXED);
+        cwake_job* job = job_at(pool, seq);
+        while (LOAD_ACQUIRE(job->ticket) != seq + 1) sched_yield();
+        struct cwake_pool_handler* handler = &pool->handlers[job->cmd];
+        uint8_t* return_buffer = job->response;
+        uint16_t return_size = 0;
+        handler->fn(handler->ctx, job->cmd, job->data, job->size,
+                    &return_buffer, &return_size);
+
+        // oversized response is rejected, as by inline dispatch
+        if (!return_buffer || return_size > sizeof(job->response)) return_size = 0;
+        if (return_size && return_buffer != job->response) {
+            memcpy(job->response, return_buffer, return_size);
+        }
+        job->rsize = return_size;
+        STORE_RELEASE(job->state, JOB_DONE);
+    }
+}
+
+// core handler of pooled commands: copy frame to next job
+static int32_t submit(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                      uint8_t** rdata, uint16_t* rsize)
+{
+    cwake_pool* pool = ctx;
+
+    if (pool->head - pool->tail == CWAKE_POOL_JOBS) {
+        pool->dropped += 1;
+        return -1;
+    }
+    cwake_job* job = job_at(pool, pool->head);
+    job->cmd = cmd;
+    job->size = size;
+    job->rsize = 0;
+    job->ordered = pool->handlers[cmd].ordered;
+    job->format = pool->platform->service.rx_format;
+    memcpy(job->data, data, size);
+    job->state = JOB_QUEUED;
+    STORE_RELEASE(job->ticket, pool->head + 1);
+    pool->head += 1;
+    sem_post(&pool->ready);
+    return 0;
+}
+
+// ========================================================== Public functional
+cwake_error cwake_pool_start(cwake_pool* pool, cwake_platform* platform, uint32_t threads)
+{
+    if (threads == 0 || threads > CWAKE_POOL_THREADS || platform->full_duplex) {
+        return CWAKE_ERROR_INVALID_DATA;
+    }
+
+    memset(pool->handlers, 0, sizeof(pool->handlers));
+    memset(pool->jobs, 0, sizeof(pool->jobs));
+    pool->platform = platform;
+    pool->stop = 0;
+    pool->head = 0;
+    pool->tail = 0;
+    pool->claim = 0;
+    pool->dropped = 0;
+    pool->threads_count = 0;
+    if (sem_init(&pool->ready, 0, 0)) return CWAKE_ERROR_IO;
+
+    while (pool->threads_count < threads) {
+        if (pthread_create(&pool->threads[pool->threads_count], NULL, worker, pool)) {
+            cwake_pool_stop(pool);
+            return CWAKE_ERROR_IO;
+        }
+        pool->threads_count += 1;
+    }
+    return CWAKE_ERROR_NONE;
+}
+
+void cwake_pool_stop(cwake_pool* pool)
+{
+    STORE_RELEASE(pool->stop, 1);
+    for (uint32_t i = 0; i < pool->threads_count; i++) {
+        sem_post(&pool->ready);
+    }
+    for (uint32_t i = 0; i < pool->threads_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pool->threads_count = 0;
+    sem_destroy(&pool->ready);
+
+    // frames are handled inline again
+    for (uint32_t cmd = 0; cmd < 256; cmd++) {
+        if (pool->handlers[cmd].fn) cwake_register_handler(pool->platform, cmd, NULL, NULL, 0);
+    }
+}
+
+cwake_error cwake_pool_register(cwake_pool* pool, uint8_t cmd,
+                                cwake_handler fn, void* ctx, uint8_t ordered)
+{
+    pool->handlers[cmd].fn = fn;
+    pool->handlers[cmd].ctx = ctx;
+    pool->handlers[cmd].ordered = ordered;
+    return cwake_register_handler(pool->platform, cmd, fn ? submit : NULL, pool, 0);
+}
+
+cwake_error cwake_pool_flush(cwake_pool* pool)
+{
+    uint8_t ordered_wait = 0;   // earlier ordered response is not sent yet
+
+    for (uint32_t seq = pool->tail; seq != pool->head; seq++) {
+        cwake_job* job = job_at(pool, seq);
+        uint32_t state = LOAD_ACQUIRE(job->state);
+
+        if (state == JOB_DONE && !(job->ordered && ordered_wait)) {
+            if (job->rsize) {
+                cwake_error err = cwake_respond(job->cmd, job->response, job->rsize,
+                                                job->format, pool->platform);
+                if (err == CWAKE_ERROR_BUSY) return err;
+                // response that can never be sent must not block the tail
+                if (err) pool->dropped += 1;
+            }
+            job->state = state = JOB_SENT;
+        }
+        if (job->ordered && state != JOB_SENT) ordered_wait = 1;
+
+        // sent jobs at the tail free their slots
+        if (seq == pool->tail && state == JOB_SENT) {
+            job->state = JOB_FREE;
+            pool->tail += 1;
+        }
+    }
+    return CWAKE_ERROR_NONE;
+}
+
+cwake_error cwake_pool_poll(cwake_pool* pool, uint32_t* handled)
+{
+    cwake_error err = cwake_pool_flush(pool);
+    uint32_t free_jobs = CWAKE_POOL_JOBS - (pool->head - pool->tail);
+
+    if (handled) *handled = 0;
+    if (err || free_jobs == 0) return err;
+    // every frame may be pooled, so no more than free jobs are taken
+    return cwake_poll_batch(pool->platform, free_jobs, handled);
+}
+
+uint32_t cwake_pool_busy(const cwake_pool* pool)
+{
+    return pool->head - pool->tail;
+}
+
+#undef LOAD_ACQUIRE
+#undef STORE_RELEASE
@@ -0,0 +1,134 @@
+/**
+ * @file cwake_pool.h
+ * @brief CWAKE worker pool for slow command handlers (POSIX threads)
+ * @author Qvafir <qvafir@outlook.com>
+ * @copyright MIT License, see repository LICENSE file
+ */
+
+#ifndef CWAKE_POOL_H
+#define CWAKE_POOL_H
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdint.h>
+
+#include "cwake.h"
+
+// number of frames handled or waiting for response (power of 2)
+#ifndef CWAKE_POOL_JOBS
+#define CWAKE_POOL_JOBS 64
+#endif
+
+// maximum number of worker threads
+#ifndef CWAKE_POOL_THREADS
+#define CWAKE_POOL_THREADS 16
+#endif
+
+// Frame copied from receiver with its response. Slot of sequence number N
+// is jobs[N % CWAKE_POOL_JOBS]; it is owned by a worker only while QUEUED.
+typedef struct cwake_job {
+    uint32_t ticket;                    // sequence number + 1, set when queued
+    uint32_t state;                     // free, queued, done or sent
+    uint8_t  cmd;
+    uint8_t  ordered;
+    uint8_t  format;                    // cwake_frame_format of request
+    uint16_t size;
+    uint16_t rsize;                     // response size (0: no response)
+    uint8_t  data[CWAKE_DATA_MAX];
+    uint8_t  response[CWAKE_DATA_MAX];
+} cwake_job;
+
+struct cwake_pool_handler {
+    cwake_handler fn;                   // NULL: command is not pooled
+    void*         ctx;
+    uint8_t       ordered;
+};
+
+typedef struct cwake_pool {
+    cwake_platform* platform;
+    pthread_t       threads[CWAKE_POOL_THREADS];
+    uint32_t        threads_count;
+    sem_t           ready;              // one post per queued job
+    uint32_t        stop;
+    uint32_t        head;               // next sequence number (poll thread)
+    uint32_t        tail;               // oldest job not sent (poll thread)
+    uint32_t        claim;              // next job taken by workers
+    uint32_t        dropped;            // frames lost because pool was full
+                                        // or their response was not sent
+    struct cwake_pool_handler handlers[256];
+    cwake_job       jobs[CWAKE_POOL_JOBS];
+} cwake_pool;
+
+/**
+ * @brief Start worker threads of pool
+ *
+ * Pool serves one platform in half-duplex mode. Only commands registered
+ * with cwake_pool_register are passed to workers, other commands are
+ * handled inline by cwake_poll as before.
+ *
+ * @param pool Pointer to cwake_pool structure object
+ * @param platform Initialized platform
+ * @param threads Number of worker threads (1 .. CWAKE_POOL_THREADS)
+ * @return cwake_error Error code (CWAKE_ERROR_INVALID_DATA in full-duplex
+ *         mode, CWAKE_ERROR_IO if threads are not started).
+ */
+cwake_error cwake_pool_start(cwake_pool* pool, cwake_platform* platform, uint32_t threads);
+
+/**
+ * @brief Stop and join worker threads (responses not sent are dropped)
+ *
+ * @param pool Pointer to cwake_pool structure object
+ */
+void cwake_pool_stop(cwake_pool* pool);
+
+/**
+ * @brief Run handler of one command on worker threads
+ *
+ * Handler is called with *rdata pointing to a prepared buffer of
+ * CWAKE_DATA_MAX bytes, larger responses are not sent. Responses are sent
+ * in the frame format of their requests. Responses of ordered commands are sent in the order of their
+ * requests (after every earlier ordered response), unordered ones as soon
+ * as they are ready.
+ *
+ * @param pool Pointer to cwake_pool structure object
+ * @param cmd Command code
+ * @param fn Handler, called on a worker thread
+ * @param ctx User context passed to fn
+ * @param ordered Keep request order of responses
+ * @return cwake_error Error code (CWAKE_ERROR_NONE == 0).
+ */
+cwake_error cwake_pool_register(cwake_pool* pool, uint8_t cmd,
+                                cwake_handler fn, void* ctx, uint8_t ordered);
+
+/**
+ * @brief Send ready responses, then receive while pool has free jobs
+ *
+ * Replaces cwake_poll for a pooled platform: frames are not taken from
+ * the port while the pool is full.
+ *
+ * @param pool Pointer to cwake_pool structure object
+ * @param handled Pointer to number of received frames (can be NULL)
+ * @return cwake_error Error code (CWAKE_ERROR_NONE == 0).
+ */
+cwake_error cwake_pool_poll(cwake_pool* pool, uint32_t* handled);
+
+/**
+ * @brief Send responses of finished jobs
+ *
+ * Response which cannot be sent for other reason than a full transmit
+ * queue (e.g. it does not fit a frame) is dropped and counted in dropped.
+ *
+ * @param pool Pointer to cwake_pool structure object
+ * @return cwake_error Error code (CWAKE_ERROR_BUSY if transmit queue is full,
+ *         sending is retried by the next call).
+ */
+cwake_error cwake_pool_flush(cwake_pool* pool);
+
+/**
+ * @brief Number of jobs queued, running or waiting for their response
+ *
+ * @param pool Pointer to cwake_pool structure object
+ * @return uint32_t Number of jobs
+ */
+uint32_t cwake_pool_busy(const cwake_pool* pool);
+
+#endif // CWAKE_POOL_H
@@ -0,0 +1,91 @@
+/**
+ * @file cwake_trace_decode.c
+ * @brief Offline decoder of CWAKE binary traces (see cwake_trace_dump)
+ * @author Qvafir <qvafir@outlook.com>
+ * @copyright MIT License, see repository LICENSE file
+ *
+ * Usage: cwake_trace_decode [dump file]   (stdin if no file is given)
+ * Dump is an array of cwake_trace_event written as is, so the decoder
+ * must be built with CWAKE_TRACE_BYTES of the traced program.
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef CWAKE_TRACE
+#define CWAKE_TRACE
+#endif
+#include "cwake.h"
+
+static const char* stage_name(uint8_t stage)
+{
+    switch (stage) {
+    case CWAKE_TRACE_RX:    return "RX";
+    case CWAKE_TRACE_FRAME: return "FRAME";
+    case CWAKE_TRACE_TX:    return "TX";
+    case CWAKE_TRACE_ERROR: return "ERROR";
+    default:                return "?";
+    }
+}
+
+static const char* error_name(int8_t code)
+{
+    switch (code) {
+    case CWAKE_ERROR_NONE:         return "";
+    case CWAKE_ERROR_TIMEOUT:      return "timeout";
+    case CWAKE_ERROR_CRC:          return "crc";
+    case CWAKE_ERROR_INVALID_DATA: return "invalid";
+    case CWAKE_ERROR_OVERFLOW:     return "overflow";
+    case CWAKE_ERROR_BUSY:         return "busy";
+    case CWAKE_ERROR_IO:           return "io";
+    default:                       return "unknown";
+    }
+}
+
+static void print_event(const cwake_trace_event* event, uint32_t previous_us)
+{
+    uint32_t stored = event->size < CWAKE_TRACE_BYTES ? event->size : CWAKE_TRACE_BYTES;
+
+    printf("%8u %12u %+10d  %-5s %-8s %6u  ", event->seq - 1, event->time_us,
+           (int32_t)(event->time_us - previous_us), stage_name(event->stage),
+           error_name(event->code), event->size);
+    for (uint32_t i = 0; i < stored; i++) printf("%02X ", event->data[i]);
+    printf(stored < event->size ? "... | " : "| ");
+    for (uint32_t i = 0; i < stored; i++) putchar(isprint(event->data[i]) ? event->data[i] : '.');
+    putchar('\n');
+}
+
+int main(int argc, char** argv)
+{
+    FILE* file = stdin;
+    cwake_trace_event event;
+    uint32_t previous_us = 0;
+    uint32_t count = 0;
+    uint32_t lost = 0;
+    uint32_t next = 0;
+
+    if (argc > 1) {
+        file = fopen(argv[1], "rb");
+        if (!file) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+
+    printf("%8s %12s %10s  %-5s %-8s %6s  %s\n",
+           "seq", "time_us", "delta_us", "stage", "error", "size", "data");
+    while (fread(&event, sizeof(event), 1, file) == 1) {
+        if (count == 0) previous_us = event.time_us;
+        // events overwritten while dumping leave gaps
+        if (count && event.seq != next) lost += event.seq - next;
+        print_event(&event, previous_us);
+        previous_us = event.time_us;
+        next = event.seq + 1;
+        count += 1;
+    }
+    printf("%u events, %u not in dump\n", count, lost);
+
+    if (file != stdin) fclose(file);
+    return 0;
+}
@@ -1,9 +1,6 @@
 #include "tests.h"
-#include "perform.h"
 
 int main()
 {
-    //cwake_lib_test();
-    cwake_lib_performance();
-    return 0;
+    return cwake_lib_test() ? 1 : 0;
 }
@@ -5,11 +5,18 @@
  * @copyright MIT License, see repository LICENSE file
  */
 
+#define _DEFAULT_SOURCE     //force enable pty and termios functional for C99 standard
+#define _XOPEN_SOURCE 600
+#include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "mock.h"
 
-uint8_t mock_tx_buffer[512];
+uint8_t mock_tx_buffer[CWAKE_TX_QUEUE_SIZE + 4096]; // whole transmit queue fits
 uint8_t mock_rx_buffer[512];
 uint32_t mock_tx_index = 0;
 uint32_t mock_rx_index = 0;
@@ -17,22 +24,26 @@ uint32_t mock_rx_start = 0;
 uint32_t mock_time_ms = 0;
 uint8_t mock_called_cmd = 0;
 uint8_t mock_rd_buffer[512];
+uint32_t mock_writev_count = 0;
+uint32_t mock_write_count = 0;
+uint32_t mock_write_limit = 0;
+const uint8_t* mock_writev_data[16];
 
 uint32_t handle_counter = 0;
 
-uint32_t mock_dummy_rw(uint8_t* buf, uint32_t count)
+uint32_t mock_dummy_rw(void* user, uint8_t* buf, uint32_t count)
 {
     return count;
 }
 
-int32_t mock_dummy_handle(uint8_t cmd, uint8_t* data, uint8_t size,
-                    uint8_t** rdata, uint8_t* rsize)
+int32_t mock_dummy_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                    uint8_t** rdata, uint16_t* rsize)
 {
     handle_counter += 1;
     return 0;
 }
 
-uint32_t mock_reread(uint8_t* buf, uint32_t count) {
+uint32_t mock_reread(void* user, uint8_t* buf, uint32_t count) {
     if (mock_rx_index <= mock_rx_start) {
         mock_rx_start = 0;
     }
@@ -51,14 +62,14 @@ uint32_t mock_reread(uint8_t* buf, uint32_t count) {
     return available;
 }
 
-uint32_t mock_read(uint8_t* buf, uint32_t count) {
+uint32_t mock_read(void* user, uint8_t* buf, uint32_t count) {
     if (mock_rx_index <= mock_rx_start) {
         mock_rx_index = 0;
         mock_rx_start = 0;
         return 0;
     }
 
-    uint8_t available = mock_rx_index - mock_rx_start;
+    uint32_t available = mock_rx_index - mock_rx_start;
 
     if ( count < available ) {
         memcpy(buf, mock_rx_buffer + mock_rx_start, count);
@@ -73,19 +84,45 @@ uint32_t mock_read(uint8_t* buf, uint32_t count) {
     return available;
 }
 
-uint32_t mock_write(uint8_t* buf, uint32_t count) {
+uint32_t mock_write(void* user, uint8_t* buf, uint32_t count) {
 
     memcpy(mock_tx_buffer, buf, count);
     mock_tx_index = count;
     return count;
 }
 
-uint32_t mock_time_ms_func() {
+uint32_t mock_write_append(void* user, uint8_t* buf, uint32_t count) {
+    memcpy(mock_tx_buffer + mock_tx_index, buf, count);
+    mock_tx_index += count;
+    mock_write_count += 1;
+    return count;
+}
+
+// port accepting no more than mock_write_limit bytes per call
+uint32_t mock_write_partial(void* user, uint8_t* buf, uint32_t count) {
+    if (count > mock_write_limit) count = mock_write_limit;
+    return mock_write_append(user, buf, count);
+}
+
+uint32_t mock_writev(void* user, const cwake_iovec* parts, uint32_t count) {
+    mock_tx_index = 0;
+    mock_writev_count = count;
+    for (uint32_t i = 0; i < count; i++) {
+        if (i < sizeof(mock_writev_data)/sizeof(mock_writev_data[0])) {
+            mock_writev_data[i] = parts[i].data;
+        }
+        memcpy(mock_tx_buffer + mock_tx_index, parts[i].data, parts[i].size);
+        mock_tx_index += parts[i].size;
+    }
+    return mock_tx_index;
+}
+
+uint32_t mock_time_ms_func(void* user) {
     return mock_time_ms;
 }
 
-int32_t mock_handle(uint8_t cmd, uint8_t* data, uint8_t size,
-                    uint8_t** rdata, uint8_t* rsize) {
+int32_t mock_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                    uint8_t** rdata, uint16_t* rsize) {
     mock_called_cmd = cmd;
     if (cmd == 0xCF) {
         char* retdata = "Hello world!";
@@ -104,6 +141,7 @@ void mock_reset_buffers() {
     mock_rx_index = 0;
     mock_rx_start = 0;
     mock_time_ms = 0;
+    mock_write_count = 0;
     memset(mock_tx_buffer, 0, sizeof(mock_tx_buffer));
     memset(mock_rx_buffer, 0, sizeof(mock_rx_buffer));
 }
@@ -119,3 +157,105 @@ cwake_platform mock_create_cwake_platform(uint8_t addr, uint32_t timeout) {
     };
     return platform;
 }
+
+int mock_pty_open(int* master, int* slave, int nonblocking)
+{
+    struct termios tio;
+
+    *slave = -1;
+    *master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (*master < 0 || grantpt(*master) || unlockpt(*master)) return -1;
+    *slave = open(ptsname(*master), O_RDWR | O_NOCTTY | (nonblocking ? O_NONBLOCK : 0));
+    if (*slave < 0 || tcgetattr(*slave, &tio)) return -1;
+    cfmakeraw(&tio);
+    return tcsetattr(*slave, TCSANOW, &tio);
+}
+
+void mock_pty_close(int master, int slave)
+{
+    if (slave >= 0) close(slave);
+    if (master >= 0) close(master);
+}
+
+uint32_t mock_fd_read(void* user, uint8_t* buf, uint32_t count) {
+    ssize_t ret = read(*(int*)user, buf, count);
+    return ret > 0 ? ret : 0;
+}
+
+uint32_t mock_fd_write(void* user, uint8_t* buf, uint32_t count) {
+    ssize_t ret = write(*(int*)user, buf, count);
+    return ret > 0 ? ret : 0;
+}
+
+uint32_t mock_clock_ms(void* user) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000 + time.tv_nsec / 1000000;
+}
+
+uint32_t mock_port_read(void* user, uint8_t* buf, uint32_t count) {
+    mock_link* link = ((mock_port*)user)->in;
+    uint32_t size = sizeof(link->data);
+
+    if (count > link->head - link->tail) count = link->head - link->tail;
+    for (uint32_t i = 0; i < count; ) {
+        uint32_t pos = link->tail % size;
+        uint32_t part = size - pos < count - i ? size - pos : count - i;
+        memcpy(buf + i, link->data + pos, part);
+        link->tail += part;
+        i += part;
+    }
+    return count;
+}
+
+static uint32_t noise_random(mock_link* link) {
+    uint32_t x = link->noise_seed ? link->noise_seed : 0x2545F491;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    link->noise_seed = x;
+    return x;
+}
+
+// byte by byte with injected errors, while two bytes fit
+static uint32_t noisy_write(mock_link* link, const uint8_t* buf, uint32_t count) {
+    uint32_t size = sizeof(link->data);
+    uint32_t i = 0;
+
+    for (; i < count && size - (link->head - link->tail) >= 2; i++) {
+        uint8_t byte = buf[i];
+        uint32_t r = noise_random(link) % 1000000;
+        if (r < link->flip_ppm) {
+            byte ^= 1 << (noise_random(link) % 8);
+            link->errors += 1;
+        }
+        else if (r < link->flip_ppm + link->lose_ppm) {
+            link->errors += 1;
+            continue;
+        }
+        else if (r < link->flip_ppm + link->lose_ppm + link->insert_ppm) {
+            link->data[link->head++ % size] = noise_random(link);
+            link->errors += 1;
+        }
+        link->data[link->head++ % size] = byte;
+    }
+    return i;
+}
+
+uint32_t mock_port_write(void* user, uint8_t* buf, uint32_t count) {
+    mock_link* link = ((mock_port*)user)->out;
+    uint32_t size = sizeof(link->data);
+
+    link->writes += 1;
+    if (link->writes == link->drop) return count;
+    if (link->flip_ppm || link->lose_ppm || link->insert_ppm) return noisy_write(link, buf, count);
+    if (count > size - (link->head - link->tail)) count = size - (link->head - link->tail);
+    for (uint32_t i = 0; i < count; ) {
+        uint32_t pos = link->head % size;
+        uint32_t part = size - pos < count - i ? size - pos : count - i;
+        memcpy(link->data + pos, buf + i, part);
+        link->head += part;
+        i += part;
+    }
+    return count;
+}
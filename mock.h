@@ -19,19 +19,58 @@ extern uint32_t mock_rx_start;
 extern uint32_t mock_time_ms;
 extern uint8_t mock_called_cmd;
 extern uint8_t mock_rd_buffer[];
+extern uint32_t mock_writev_count;
+extern uint32_t mock_write_count;
+extern uint32_t mock_write_limit;
+extern const uint8_t* mock_writev_data[];
 
 extern uint32_t handle_counter;
 
-uint32_t mock_dummy_rw(uint8_t* buf, uint32_t count);
-int32_t mock_dummy_handle(uint8_t cmd, uint8_t* data, uint8_t size,
-                    uint8_t** rdata, uint8_t* rsize);
-uint32_t mock_reread(uint8_t* buf, uint32_t count);
+uint32_t mock_dummy_rw(void* user, uint8_t* buf, uint32_t count);
+int32_t mock_dummy_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                    uint8_t** rdata, uint16_t* rsize);
+uint32_t mock_reread(void* user, uint8_t* buf, uint32_t count);
 
-uint32_t mock_read(uint8_t* buf, uint32_t count);
-uint32_t mock_write(uint8_t* buf, uint32_t count);
-uint32_t mock_time_ms_func();
-int32_t mock_handle(uint8_t cmd, uint8_t* data, uint8_t size,
-                    uint8_t** rdata, uint8_t* rsize);
+uint32_t mock_read(void* user, uint8_t* buf, uint32_t count);
+uint32_t mock_write(void* user, uint8_t* buf, uint32_t count);
+uint32_t mock_write_append(void* user, uint8_t* buf, uint32_t count);
+uint32_t mock_write_partial(void* user, uint8_t* buf, uint32_t count);
+uint32_t mock_writev(void* user, const cwake_iovec* parts, uint32_t count);
+uint32_t mock_time_ms_func(void* user);
+int32_t mock_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                    uint8_t** rdata, uint16_t* rsize);
 void mock_reset_buffers();
 cwake_platform mock_create_cwake_platform(uint8_t addr, uint32_t timeout);
+
+// pseudo-terminal pair in raw mode, slave end is nonblocking if requested
+int mock_pty_open(int* master, int* slave, int nonblocking);
+void mock_pty_close(int master, int slave);
+// read/write file descriptor pointed by user context
+uint32_t mock_fd_read(void* user, uint8_t* buf, uint32_t count);
+uint32_t mock_fd_write(void* user, uint8_t* buf, uint32_t count);
+uint32_t mock_clock_ms(void* user);
+
+// in-memory one-way link (ring), losing selected write call; line noise
+// rates are errors per million written bytes
+typedef struct mock_link {
+    uint8_t  data[8192];
+    uint32_t head;          // write counter
+    uint32_t tail;          // read counter
+    uint32_t writes;        // number of write calls
+    uint32_t drop;          // write call to lose (1-based, 0: none)
+    uint32_t flip_ppm;      // one bit of byte is flipped
+    uint32_t lose_ppm;      // byte is lost
+    uint32_t insert_ppm;    // random byte is inserted before byte
+    uint32_t noise_seed;    // state of noise generator
+    uint32_t errors;        // injected errors
+} mock_link;
+
+// platform end of two links (user context of mock_port_read/write)
+typedef struct mock_port {
+    mock_link* in;
+    mock_link* out;
+} mock_port;
+
+uint32_t mock_port_read(void* user, uint8_t* buf, uint32_t count);
+uint32_t mock_port_write(void* user, uint8_t* buf, uint32_t count);
 #endif
@@ -4,97 +4,1669 @@
  * @author Qvafir <qvafir@outlook.com>
  * @copyright MIT License, see repository LICENSE file
  */
+#define _DEFAULT_SOURCE     //force enable pty and termios functional for C99 standard
+#define _XOPEN_SOURCE 600
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "cwake.h"
+#include "cwake_bulk.h"
+#include "cwake_hub.h"
+#include "cwake_pool.h"
 #include "mock.h"
 #include "common.h"
 
+#ifndef CWAKE_TEST
+// WAKE protocol codes (exported by cwake.c in test builds)
+static const uint8_t FEND = 0xC0;
+static const uint8_t FESC = 0xDB;
+#endif
 
-#define PACKET_SIZE 250 // Size of each packet in bytes
-#define NUM_PACKETS 10000 // Number of packets to send
+#define SUITE_WARMUP 50 // Number of samples run before measurement of a case
+#define SUITE_SAMPLES 1000 // Number of timed samples per case
+#define SUITE_FRAMES 16 // Number of frames per sample
+#define SUITE_STREAM 64 // Number of encoded frames read in a loop by decode stage
+#define NUM_DESTUFF 100000 // Number of destuff() calls per measurement
+#define NUM_CHUNKS 100000 // Number of 512-byte chunks for framing measurement
+#define NUM_ROUNDS 2000 // Number of polling rounds for pty measurement
+#define ROUND_FRAMES 32 // Number of frames per polling round
+#define NUM_INSTANCES 8 // Max number of instances polled on own threads
+#define INSTANCE_FRAMES 100000 // Number of frames looped back by every instance
+#define HUB_PORTS 256 // Max number of pty ports served by hub
+#define HUB_FRAMES 5000 // Number of frames received per measurement
+#define DUPLEX_FRAMES 20000 // Number of frames per direction for duplex measurement
+#define ROUNDTRIP_WARMUP 100 // Number of requests before round trips are timed
+#define ROUNDTRIP_CALLS 2000 // Number of timed request/response round trips
+#define ROUNDTRIP_STREAM 20000 // Number of frames streamed to server per measurement
+#define ROUNDTRIP_STALL_MS 1000 // Measurement is abandoned if no frame passes for so long
+#define ASYNC_CALLS 5000 // Number of calls per async measurement
+#define ASYNC_DELAY_US 100 // Response delay of emulated slaves
+#define DISPATCH_COMMANDS (CWAKE_HANDLERS < 60 ? CWAKE_HANDLERS : 60) // Number of commands served by emulated firmware
+#define DISPATCH_FRAMES 1000000 // Number of frames per dispatch measurement
+#define POOL_FRAMES 20000 // Number of frames per worker pool measurement
+#define POOL_SLOW_US 200 // Handling time of slow command (flash read)
+#define POOL_THREADS 4 // Number of worker threads
+#define BULK_SIZE (256 * 1024) // Size of bulk transfer
+#define BULK_RATE 1000000 // Emulated link rate in bytes per second
+#define BULK_LATENCY_US 200 // Emulated one-way link latency
+#define EXT_SIZE (1024 * 1024) // Size of payload sent in classic and extended frames
+#define EXT_ROUNDS 16 // Number of times payload is sent per measurement
+#define NOISE_FRAMES 20000 // Number of frames sent over noisy link per measurement
+#define NOISE_PAYLOAD 64 // Payload size of frames sent over noisy link
 
-static uint8_t packet[PACKET_SIZE];
 static cwake_platform platform;
 
-// Function to measure the time taken to send packets
-static double measure_time(void (*operation)(void)) {
-    clock_t start, end;
-    double duration;
+// Frame suite: encode (cwake_call), decode (cwake_poll of a looped stream)
+// and loopback (call, echo by peer, response) for every payload type and
+// size. A sample times SUITE_FRAMES frames, p50/p99 are taken of per-frame
+// sample times. Results are printed as CSV for comparison between releases.
+enum {
+    PAYLOAD_RANDOM = 0,
+    PAYLOAD_PLAIN,          // no FEND/FESC bytes
+    PAYLOAD_ESCAPE,         // FEND/FESC bytes only
+    PAYLOAD_MIXED,          // every 4th byte is FEND/FESC
+    PAYLOAD_TYPES
+};
+static const char* const payload_names[PAYLOAD_TYPES] = {
+    "random", "escape-free", "all-escape", "mixed"
+};
+// 252 B exceeds classic frames, it is sent as extended frame if CWAKE_DATA_MAX allows
+static const uint16_t suite_sizes[] = {0, 1, 4, 16, 32, 64, 128, 192, 251, 252};
 
-    start = clock();
-    operation(); // Call the function that sends packets
-    end = clock();
+static struct {
+    cwake_platform master;      // encode and decode stages run on master only
+    cwake_platform slave;
+    mock_link to_slave;
+    mock_link to_master;
+    mock_port master_port;
+    mock_port slave_port;
+    uint8_t  payload[CWAKE_DATA_MAX];
+    uint16_t size;
+    uint8_t  stream[SUITE_STREAM * CWAKE_FRAME_ENC_MAX];
+    uint32_t stream_size;
+    uint32_t stream_pos;
+    uint64_t samples[SUITE_SAMPLES];
+} suite;
 
-    duration = (double)(end - start) / CLOCKS_PER_SEC; // Calculate the time taken in seconds
+static void suite_payload(uint8_t* payload, uint16_t size, int type)
+{
+    uint32_t seed = 0x9E3779B9 + size;
+
+    for (uint16_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint8_t byte = seed >> 24;
+        if (type == PAYLOAD_PLAIN && (byte == FEND || byte == FESC)) byte ^= 0x01;
+        if (type == PAYLOAD_ESCAPE || (type == PAYLOAD_MIXED && i % 4 == 0)) {
+            byte = (seed >> 16) & 1 ? FEND : FESC;
+        }
+        payload[i] = byte;
+    }
+}
+
+static uint32_t suite_stream_write(void* user, uint8_t* buf, uint32_t count)
+{
+    memcpy(suite.stream + suite.stream_size, buf, count);
+    suite.stream_size += count;
+    return count;
+}
+
+// stream of whole frames is read again from its start
+static uint32_t suite_stream_read(void* user, uint8_t* buf, uint32_t count)
+{
+    if (suite.stream_pos == suite.stream_size) suite.stream_pos = 0;
+    uint32_t size = suite.stream_size - suite.stream_pos;
+    if (size > count) size = count;
+    memcpy(buf, suite.stream + suite.stream_pos, size);
+    suite.stream_pos += size;
+    return size;
+}
+
+// empty request is answered by a status byte (empty response is not sent)
+static int32_t suite_echo(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                          uint8_t** rdata, uint16_t* rsize)
+{
+    memcpy(*rdata, data, size);
+    if (size == 0) (*rdata)[size++] = 0;
+    *rsize = size;
+    return 0;
+}
 
-    return duration;
+static void suite_encode(void)
+{
+    for (int i = 0; i < SUITE_FRAMES; i++) {
+        cwake_call(0x01, 0x10, suite.payload, suite.size, &suite.master);
+    }
 }
 
-// Function to create and send packets using cwake library
-void send_packets(void) {
-    for (int i = 0; i < NUM_PACKETS; i++) {
-        cwake_call(FEND, FEND, packet, PACKET_SIZE, &platform);
+static void suite_decode(void)
+{
+    uint32_t handled = 0;
+
+    while (handled < SUITE_FRAMES) {
+        uint32_t frames = 0;
+        if (cwake_poll_batch(&suite.master, SUITE_FRAMES - handled, &frames)) return;
+        handled += frames;
     }
 }
 
-// Function to read and handle packets using cwake library
-void handle_packets(void) {
-    while (handle_counter < NUM_PACKETS) {
-        int err = cwake_poll(&platform);
-        if ( err ) {
-            log("cwake_poll err: %d", err);
-            return;
+// escaped frames may take several reads of receive buffer
+static void suite_loopback(void)
+{
+    for (int i = 0; i < SUITE_FRAMES; i++) {
+        uint32_t handled = handle_counter;
+        cwake_call(0x01, 0x10, suite.payload, suite.size, &suite.master);
+        for (int polls = 0; handle_counter == handled && polls < 8; polls++) {
+            cwake_poll(&suite.slave);
+            cwake_poll(&suite.master);
         }
     }
 }
 
-void cwake_lib_performance(void)
+static int compare_u64(const void* a, const void* b)
 {
-    log("PERFORMANCE TEST...");
-    memset(packet, FEND, PACKET_SIZE); // Fill the packet with dummy data
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// run stage of one case and print its CSV row, 0 if frames were lost
+static uint8_t suite_measure(const char* stage, void (*run)(void), int type, uint8_t format)
+{
+    uint64_t total = 0;
+
+    for (int i = 0; i < SUITE_WARMUP; i++) run();
+    handle_counter = 0;
+    for (int i = 0; i < SUITE_SAMPLES; i++) {
+        uint64_t start = time_now_ns();
+        run();
+        suite.samples[i] = time_now_ns() - start;
+        total += suite.samples[i];
+    }
+    qsort(suite.samples, SUITE_SAMPLES, sizeof(suite.samples[0]), compare_u64);
+
+    double ns_frame = (double)total / (SUITE_SAMPLES * SUITE_FRAMES);
+    printf("%s,%s,%u,%s,%.1f,%.2f,%.1f,%.1f\n", stage, payload_names[type], suite.size,
+           format == CWAKE_FRAME_CLASSIC ? "classic" : "crc16", ns_frame,
+           suite.size / ns_frame * 1e9 / 1048576.0,
+           (double)suite.samples[SUITE_SAMPLES / 2] / SUITE_FRAMES,
+           (double)suite.samples[SUITE_SAMPLES * 99 / 100] / SUITE_FRAMES);
+    // encoding calls no handler
+    return run == suite_encode || handle_counter == SUITE_SAMPLES * SUITE_FRAMES;
+}
+
+static void suite_performance(void)
+{
+    uint32_t lost = 0;
+
+    suite.master_port = (mock_port){&suite.to_master, &suite.to_slave};
+    suite.slave_port = (mock_port){&suite.to_slave, &suite.to_master};
+
+    log("Frame suite: %d samples of %d frames per case (CSV)", SUITE_SAMPLES, SUITE_FRAMES);
+    printf("stage,payload,size,format,ns_frame,mb_s,p50_ns,p99_ns\n");
+    for (size_t n = 0; n < sizeof(suite_sizes)/sizeof(suite_sizes[0]); n++) {
+        if (suite_sizes[n] > CWAKE_DATA_MAX) continue;
+        uint8_t format = suite_sizes[n] > 251 ? CWAKE_FRAME_CRC16 : CWAKE_FRAME_CLASSIC;
+        suite.size = suite_sizes[n];
+
+        for (int type = 0; type < PAYLOAD_TYPES; type++) {
+            suite_payload(suite.payload, suite.size, type);
+
+            // encode: write accepts everything at once
+            suite.master = mock_create_cwake_platform(0x00, 5);
+            suite.master.frame_format = format;
+            suite.master.write = mock_dummy_rw;
+            cwake_init(&suite.master);
+            lost += !suite_measure("encode", suite_encode, type, format);
+
+            // decode: same encoded frames are read again and again
+            suite.stream_size = 0;
+            suite.stream_pos = 0;
+            suite.master.write = suite_stream_write;
+            for (int i = 0; i < SUITE_STREAM; i++) {
+                cwake_call(0x01, 0x10, suite.payload, suite.size, &suite.master);
+            }
+            suite.master.read = suite_stream_read;
+            suite.master.handle = mock_dummy_handle;
+            cwake_init(&suite.master);
+            lost += !suite_measure("decode", suite_decode, type, format);
+
+            // loopback: slave echoes every frame through in-memory links
+            memset(&suite.to_slave, 0, sizeof(suite.to_slave));
+            memset(&suite.to_master, 0, sizeof(suite.to_master));
+            suite.master.user = &suite.master_port;
+            suite.master.read = mock_port_read;
+            suite.master.write = mock_port_write;
+            cwake_init(&suite.master);
+            suite.slave = mock_create_cwake_platform(0x01, 5);
+            suite.slave.user = &suite.slave_port;
+            suite.slave.read = mock_port_read;
+            suite.slave.write = mock_port_write;
+            cwake_init(&suite.slave);
+            cwake_register_handler(&suite.slave, 0x10, suite_echo, NULL, CWAKE_DATA_MAX);
+            lost += !suite_measure("loopback", suite_loopback, type, format);
+        }
+    }
+    if (lost) log("Frame suite: frames lost in %u cases", lost);
+}
+
+// CRC-8 throughput of bulk API and of bytewise table lookups
+static void crc_performance(void)
+{
+    const size_t sizes[] = {16, 64, 256, 4096};
+    static uint8_t data[4096];
+    uint8_t table[256];
+    const uint8_t polynomial = 0x31;    // CRC-8 of cwake_crc8
+
+    for (int i = 0; i < 256; i++) {
+        uint8_t crc = i;
+        for (int j = 0; j < 8; j++) crc = (crc & 0x80) ? (crc << 1) ^ polynomial : crc << 1;
+        table[i] = crc;
+    }
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = i * 31;
+
+    for (size_t n = 0; n < sizeof(sizes)/sizeof(sizes[0]); n++) {
+        size_t total = (size_t)NUM_DESTUFF * 256;
+        size_t rounds = total / sizes[n];
+        volatile uint8_t sink = 0;
+
+        uint64_t start = time_now_ns();
+        for (size_t r = 0; r < rounds; r++) {
+            uint8_t crc = 0;
+            for (size_t i = 0; i < sizes[n]; i++) crc = table[crc ^ data[i]];
+            sink ^= crc;
+        }
+        uint64_t bytewise = time_now_ns() - start;
+
+        start = time_now_ns();
+        for (size_t r = 0; r < rounds; r++) {
+            sink ^= cwake_crc8(data, sizes[n], 0);
+        }
+        uint64_t sliced = time_now_ns() - start;
+
+        log("CRC-8 %4u bytes: bytewise %.2f MB/s, cwake_crc8 %.2f MB/s (x%.2f)",
+            (unsigned)sizes[n],
+            total / (bytewise / 1e9) / 1048576.0,
+            total / (sliced / 1e9) / 1048576.0,
+            (double)bytewise / sliced);
+    }
+}
+
+#ifdef CWAKE_TEST
+// Kernel benchmarks call internals of cwake.c, exported in test builds only
+
+// Measure destuff() speed of selected kernel on one encoded frame
+static double destuff_speed(int kernel, const uint8_t* encoded, size_t encoded_size)
+{
+    uint8_t decoded[256];
+    size_t decoded_size = 0;
+
+    select_kernels(kernel);
+    uint64_t start = time_now_ns();
+    for (int i = 0; i < NUM_DESTUFF; i++) {
+        decoded_size = destuff(encoded, encoded_size, decoded, sizeof(decoded));
+    }
+    uint64_t duration = time_now_ns() - start;
+
+    return (double)decoded_size * NUM_DESTUFF / (duration / 1e9) / 1048576.0;
+}
+
+// destuff() at several escape densities (percent of FEND/FESC bytes)
+static void destuff_performance(void)
+{
+    const int densities[] = {0, 1, 10, 50, 100};
+    uint8_t decoded[252];
+    uint8_t encoded[512];
+    uint32_t seed = 1;
+
+    int best = select_kernels(KERNEL_AVX2);
+    for (size_t d = 0; d < sizeof(densities)/sizeof(densities[0]); d++) {
+        for (size_t i = 0; i < sizeof(decoded); i++) {
+            seed = seed * 1103515245 + 12345;
+            if ((int)((seed >> 16) % 100) < densities[d]) {
+                decoded[i] = (seed & 1) ? FEND : FESC;
+            } else {
+                decoded[i] = 0x20 + (seed >> 24) % 0x60;
+            }
+        }
+        size_t encoded_size = stuff_scalar(decoded, sizeof(decoded), encoded);
+
+        double scalar = destuff_speed(KERNEL_SCALAR, encoded, encoded_size);
+        double vector = destuff_speed(best, encoded, encoded_size);
+        log("Destuff %3d%% escapes: scalar %.2f MB/s, kernel %d %.2f MB/s (x%.2f)",
+            densities[d], scalar, best, vector, vector / scalar);
+    }
+    select_kernels(KERNEL_AVX2);
+}
+
+// Decode and validate one frame with destuff() and a separate crc pass
+static uint8_t validate_separate(const uint8_t* encoded, size_t encoded_size, uint8_t* decoded)
+{
+    uint8_t preamble[] = {FEND};
+    size_t decoded_size = destuff(encoded, encoded_size, decoded, 256);
+    return get_crc8(decoded, decoded_size, get_crc8(preamble, 1, 0));
+}
+
+// Decode and validate one frame with crc carried inside destuffing
+static uint8_t validate_fused(const uint8_t* encoded, size_t encoded_size, uint8_t* decoded)
+{
+    uint8_t preamble[] = {FEND};
+    uint8_t crc = get_crc8(preamble, 1, 0);
+    destuff_crc8(encoded, encoded_size, decoded, 256, &crc);
+    return crc;
+}
+
+static double validate_speed(uint8_t (*validate)(const uint8_t*, size_t, uint8_t*),
+                             const uint8_t* encoded, size_t encoded_size, size_t frame_size)
+{
+    uint8_t decoded[256];
+    uint8_t crc = 0;
+
+    uint64_t start = time_now_ns();
+    for (int i = 0; i < NUM_DESTUFF; i++) {
+        crc |= validate(encoded, encoded_size, decoded);
+    }
+    uint64_t duration = time_now_ns() - start;
+
+    if (crc) log("validation failed");
+    return (double)frame_size * NUM_DESTUFF / (duration / 1e9) / 1048576.0;
+}
+
+// DESTUFFING + VALIDATING stages with and without fused crc
+static void validate_performance(void)
+{
+    const int densities[] = {0, 10, 100};
+    uint8_t payload[251];
+    uint32_t seed = 7;
 
-    // sending test
     platform = mock_create_cwake_platform(0x01, 5);
     platform.read = mock_dummy_rw;
-    platform.write = mock_dummy_rw;
+    platform.write = mock_write;
     cwake_init(&platform);
 
-    double send_duration;
-    double send_speed;
-    send_duration = measure_time(send_packets);
-    send_speed = (NUM_PACKETS * PACKET_SIZE) / send_duration;
+    for (size_t d = 0; d < sizeof(densities)/sizeof(densities[0]); d++) {
+        for (size_t i = 0; i < sizeof(payload); i++) {
+            seed = seed * 1103515245 + 12345;
+            if ((int)((seed >> 16) % 100) < densities[d]) {
+                payload[i] = (seed & 1) ? FEND : FESC;
+            } else {
+                payload[i] = 0x20 + (seed >> 24) % 0x60;
+            }
+        }
+        cwake_call(0x01, 0x10, payload, sizeof(payload), &platform);
+
+        // preamble is not a part of destuffed data
+        double separate = validate_speed(validate_separate, mock_tx_buffer + 1,
+                                         mock_tx_index - 1, sizeof(payload));
+        double fused = validate_speed(validate_fused, mock_tx_buffer + 1,
+                                      mock_tx_index - 1, sizeof(payload));
+        log("Validate %3d%% escapes: separate crc %.2f MB/s, fused crc %.2f MB/s (x%.2f)",
+            densities[d], separate, fused, fused / separate);
+    }
+}
+
+// Frame search as bytewise loops (previous cwake_poll FRAMING stage)
+static uint32_t frames_by_loop(const uint8_t* buf, size_t size)
+{
+    const uint8_t* end = buf + size;
+    const uint8_t* fstart = buf;
+    uint32_t frames = 0;
+
+    while (fstart < end) {
+        while (fstart < end && *fstart == FEND) fstart += 1;
+        const uint8_t* fend = fstart;
+        while (fend < end && *fend != FEND) fend += 1;
+        if (fend > fstart) frames += 1;
+        fstart = fend;
+    }
+    return frames;
+}
+
+// Frame search with one scan_fend() pass and FEND bitmap lookups
+static uint32_t frames_by_scan(const uint8_t* buf, size_t size)
+{
+    uint64_t map[512/64];
+    size_t fstart = 0;
+    uint32_t frames = 0;
+
+    scan_fend(buf, 0, size, map);
+    while (fstart < size) {
+        while (fstart < size && (map[fstart / 64] >> (fstart % 64) & 1)) fstart += 1;
+        size_t fend = fstart + find_fend(map, fstart, size - fstart);
+        if (fend > fstart) frames += 1;
+        fstart = fend;
+    }
+    return frames;
+}
+
+static double framing_speed(uint32_t (*search)(const uint8_t*, size_t),
+                            const uint8_t* chunk, size_t size, uint32_t* frames)
+{
+    uint64_t start = time_now_ns();
+    for (int i = 0; i < NUM_CHUNKS; i++) {
+        *frames = search(chunk, size);
+    }
+    uint64_t duration = time_now_ns() - start;
+    return (double)duration / NUM_CHUNKS;
+}
+
+// FRAMING stage search on 512-byte reads holding many small frames
+static void framing_performance(void)
+{
+    const uint8_t payload_sizes[] = {0, 4, 16, 60};
+    uint8_t chunk[512];
+    uint8_t payload[64];
+
+    memset(payload, 0x5A, sizeof(payload));
+    platform = mock_create_cwake_platform(0x01, 5);
+    platform.read = mock_dummy_rw;
+    platform.write = mock_write;
+    cwake_init(&platform);
+
+    for (size_t p = 0; p < sizeof(payload_sizes); p++) {
+        size_t size = 0;
+        while (1) {
+            cwake_call(0x01, 0x10, payload, payload_sizes[p], &platform);
+            if (size + mock_tx_index > sizeof(chunk)) break;
+            memcpy(chunk + size, mock_tx_buffer, mock_tx_index);
+            size += mock_tx_index;
+        }
+
+        uint32_t loop_frames = 0;
+        uint32_t scan_frames = 0;
+        double loop_ns = framing_speed(frames_by_loop, chunk, size, &loop_frames);
+        double scan_ns = framing_speed(frames_by_scan, chunk, size, &scan_frames);
+        log("Framing %3u frames/read: loop %.1f ns/read, scan %.1f ns/read (x%.2f)%s",
+            loop_frames, loop_ns, scan_ns, loop_ns / scan_ns,
+            loop_frames == scan_frames ? "" : " MISMATCH");
+    }
+}
+#endif
 
-    // handling test
+static int pty_master = -1;
+static int pty_slave = -1;
+static uint32_t pty_writes = 0;
+
+static uint32_t pty_write(void* user, uint8_t* buf, uint32_t count)
+{
+    uint32_t written = 0;
+    while (written < count) {
+        ssize_t ret = write(pty_master, buf + written, count - written);
+        pty_writes += 1;
+        if (ret <= 0) break;
+        written += ret;
+    }
+    return written;
+}
+
+static void pty_drain(size_t count)
+{
+    uint8_t buf[4096];
+    while (count) {
+        ssize_t ret = read(pty_slave, buf, count < sizeof(buf) ? count : sizeof(buf));
+        if (ret <= 0) return;
+        count -= ret;
+    }
+}
+
+// Polling rounds of ROUND_FRAMES calls written separately or as one batch
+static double pty_rounds(uint8_t* batch, uint32_t batch_size,
+                         uint8_t* payload, uint8_t payload_size, size_t* bytes)
+{
+    size_t round_bytes = 0;
+
+    // size of one round on the line
+    platform.write = mock_write;
+    for (int f = 0; f < ROUND_FRAMES; f++) {
+        cwake_call(f + 1, 0x10, payload, payload_size, &platform);
+        round_bytes += mock_tx_index;
+    }
+    platform.write = pty_write;
+    pty_writes = 0;
+
+    uint64_t start = time_now_ns();
+    for (int r = 0; r < NUM_ROUNDS; r++) {
+        if (batch) cwake_batch_begin(&platform, batch, batch_size);
+        for (int f = 0; f < ROUND_FRAMES; f++) {
+            cwake_call(f + 1, 0x10, payload, payload_size, &platform);
+        }
+        if (batch) cwake_batch_flush(&platform);
+        pty_drain(round_bytes);
+    }
+    uint64_t duration = time_now_ns() - start;
+
+    *bytes = round_bytes * NUM_ROUNDS;
+    return duration / 1e9;
+}
+
+// Polling many slaves: one write per frame vs batched transmit over pty
+static void batch_performance(void)
+{
+    const uint8_t payload_sizes[] = {4, 16, 64};
+    static uint8_t batch[4096];
+    uint8_t payload[64];
+
+    // blocking slave end, pty_drain waits for whole round
+    if (mock_pty_open(&pty_master, &pty_slave, 0)) {
+        log("Batch transmit: pty is not available");
+        mock_pty_close(pty_master, pty_slave);
+        return;
+    }
+    memset(payload, 0x5A, sizeof(payload));
+    platform = mock_create_cwake_platform(0x00, 5);
+    cwake_init(&platform);
+
+    for (size_t p = 0; p < sizeof(payload_sizes); p++) {
+        size_t bytes = 0;
+        double single = pty_rounds(NULL, 0, payload, payload_sizes[p], &bytes);
+        uint32_t single_writes = pty_writes;
+        double batched = pty_rounds(batch, sizeof(batch), payload, payload_sizes[p], &bytes);
+        uint32_t batched_writes = pty_writes;
+
+        log("Batch transmit %2u B payload: single %u writes %.2f MB/s, batch %u writes %.2f MB/s (x%.2f)",
+            payload_sizes[p],
+            single_writes, bytes / single / 1048576.0,
+            batched_writes, bytes / batched / 1048576.0,
+            single / batched);
+    }
+    mock_pty_close(pty_master, pty_slave);
+}
+
+// Instance with loopback line, reached by callbacks through platform.user
+struct instance {
+    cwake_platform platform;
+    pthread_t thread;
+    uint8_t payload[250];
+    uint8_t line[512];
+    uint32_t line_size;
+    uint32_t line_pos;
+    uint32_t handled;
+};
+
+static uint32_t instance_read(void* user, uint8_t* buf, uint32_t count)
+{
+    struct instance* inst = user;
+    uint32_t size = inst->line_size - inst->line_pos;
+
+    if (size > count) size = count;
+    memcpy(buf, inst->line + inst->line_pos, size);
+    inst->line_pos += size;
+    return size;
+}
+
+static uint32_t instance_write(void* user, uint8_t* buf, uint32_t count)
+{
+    struct instance* inst = user;
+
+    memcpy(inst->line, buf, count);
+    inst->line_size = count;
+    inst->line_pos = 0;
+    return count;
+}
+
+static uint32_t instance_time_ms(void* user)
+{
+    return 0;
+}
+
+static int32_t instance_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                               uint8_t** rdata, uint16_t* rsize)
+{
+    struct instance* inst = user;
+    inst->handled += 1;
+    return 0;
+}
+
+// send every frame to own line and poll it back
+static void* instance_run(void* arg)
+{
+    struct instance* inst = arg;
+
+    for (uint32_t i = 0; i < INSTANCE_FRAMES; i++) {
+        cwake_call(0x01, 0x10, inst->payload, sizeof(inst->payload), &inst->platform);
+        while (inst->handled == i) {
+            if (cwake_poll(&inst->platform)) return NULL;
+        }
+    }
+    return NULL;
+}
+
+// Independent instances on own threads, total throughput should grow
+// with number of instances up to number of cores
+static void instances_performance(void)
+{
+    static struct instance instances[NUM_INSTANCES];
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    double single = 0;
+
+    for (uint32_t n = 1; n <= NUM_INSTANCES; n *= 2) {
+        for (uint32_t i = 0; i < n; i++) {
+            struct instance* inst = &instances[i];
+            memset(inst, 0, sizeof(*inst));
+            for (size_t b = 0; b < sizeof(inst->payload); b++) {
+                inst->payload[b] = (b % 16) ? (uint8_t)(b + i) : FEND;
+            }
+            inst->platform.addr = 0x01;
+            inst->platform.timeout_ms = 5;
+            inst->platform.user = inst;
+            inst->platform.read = instance_read;
+            inst->platform.write = instance_write;
+            inst->platform.current_time_ms = instance_time_ms;
+            inst->platform.handle = instance_handle;
+            cwake_init(&inst->platform);
+        }
+
+        uint64_t start = time_now_ns();
+        for (uint32_t i = 0; i < n; i++) {
+            pthread_create(&instances[i].thread, NULL, instance_run, &instances[i]);
+        }
+        uint32_t handled = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            pthread_join(instances[i].thread, NULL);
+            handled += instances[i].handled;
+        }
+        double seconds = (time_now_ns() - start) / 1e9;
+
+        double total = handled * sizeof(instances[0].payload) / seconds / 1048576.0;
+        if (n == 1) single = total;
+        log("Instances %u (%ld cores): %.2f MB/s total, %.2f MB/s per instance (x%.2f)%s",
+            n, cores, total, total / n, total / single,
+            handled == n * INSTANCE_FRAMES ? "" : " LOST FRAMES");
+    }
+}
+
+static int hub_master[HUB_PORTS];
+static int hub_slave[HUB_PORTS];
+static cwake_platform hub_platforms[HUB_PORTS];
+
+// CPU time per received frame with every port polled in turn or by hub
+static double hub_cpu_per_frame(uint32_t ports, cwake_hub* hub,
+                                const uint8_t* frame, uint32_t frame_size)
+{
+    clock_t start = clock();
     handle_counter = 0;
-    platform = mock_create_cwake_platform(FEND, 5);
+    for (uint32_t f = 0; f < HUB_FRAMES; f++) {
+        mock_fd_write(&hub_master[(f * 7) % ports], (uint8_t*)frame, frame_size);
+        while (handle_counter == f) {
+            if (hub) {
+                cwake_hub_poll(hub, -1, NULL);
+            } else {
+                for (uint32_t p = 0; p < ports; p++) cwake_poll(&hub_platforms[p]);
+            }
+        }
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC / HUB_FRAMES * 1e6;
+}
+
+static void hub_performance(void)
+{
+    static cwake_hub_port storage[HUB_PORTS];
+    const uint32_t port_counts[] = {1, 16, 64, HUB_PORTS};
+    uint8_t payload[64];
+    uint8_t frame[256];
+    uint32_t opened = 0;
+
+    memset(payload, 0x5A, sizeof(payload));
+    platform = mock_create_cwake_platform(0x01, 5);
+    cwake_init(&platform);
+    cwake_call(0x01, 0x10, payload, sizeof(payload), &platform);
+    uint32_t frame_size = mock_tx_index;
+    memcpy(frame, mock_tx_buffer, frame_size);
+
+    for (; opened < HUB_PORTS; opened++) {
+        if (mock_pty_open(&hub_master[opened], &hub_slave[opened], 1)) {
+            mock_pty_close(hub_master[opened], hub_slave[opened]);
+            break;
+        }
+        hub_platforms[opened] = mock_create_cwake_platform(0x01, 100);
+        hub_platforms[opened].user = &hub_slave[opened];
+        hub_platforms[opened].read = mock_fd_read;
+        hub_platforms[opened].handle = mock_dummy_handle;
+        hub_platforms[opened].current_time_ms = mock_clock_ms;
+        cwake_init(&hub_platforms[opened]);
+    }
+
+    for (size_t c = 0; c < sizeof(port_counts)/sizeof(port_counts[0]); c++) {
+        uint32_t ports = port_counts[c];
+        cwake_hub hub;
+
+        if (ports > opened) {
+            log("Hub %u ports: only %u pty pairs available", ports, opened);
+            break;
+        }
+        cwake_hub_init(&hub, storage, ports);
+        for (uint32_t p = 0; p < ports; p++) cwake_hub_add(&hub, &hub_platforms[p], hub_slave[p]);
+
+        double loop_us = hub_cpu_per_frame(ports, NULL, frame, frame_size);
+        double hub_us = hub_cpu_per_frame(ports, &hub, frame, frame_size);
+        log("Hub %3u ports: poll loop %.2f us CPU/frame, hub %.2f us CPU/frame (x%.2f)",
+            ports, loop_us, hub_us, loop_us / hub_us);
+        cwake_hub_close(&hub);
+    }
+
+    for (uint32_t p = 0; p < opened; p++) mock_pty_close(hub_master[p], hub_slave[p]);
+}
+
+#if CWAKE_FULL_DUPLEX
+// Platform linked to peer threads with a pipe for each direction
+struct duplex_link {
+    cwake_platform platform;
+    int in[2];              // peer -> platform
+    int out[2];             // platform -> peer
+    uint8_t frame[512];     // encoded request sent by peer
+    uint32_t frame_size;
+    uint8_t payload[250];
+    uint32_t handled;
+    uint8_t rx;             // directions in use
+    uint8_t tx;
+};
+
+static uint32_t duplex_read(void* user, uint8_t* buf, uint32_t count)
+{
+    ssize_t ret = read(((struct duplex_link*)user)->in[0], buf, count);
+    return ret > 0 ? ret : 0;
+}
+
+static uint32_t duplex_write(void* user, uint8_t* buf, uint32_t count)
+{
+    ssize_t ret = write(((struct duplex_link*)user)->out[1], buf, count);
+    return ret > 0 ? ret : 0;
+}
+
+static int32_t duplex_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                             uint8_t** rdata, uint16_t* rsize)
+{
+    ((struct duplex_link*)user)->handled += 1;
+    return 0;
+}
+
+static void* duplex_feed(void* arg)
+{
+    struct duplex_link* link = arg;
+    for (int i = 0; i < DUPLEX_FRAMES; i++) {
+        uint32_t written = 0;
+        while (written < link->frame_size) {
+            ssize_t ret = write(link->in[1], link->frame + written, link->frame_size - written);
+            if (ret <= 0) return NULL;
+            written += ret;
+        }
+    }
+    return NULL;
+}
+
+static void* duplex_drain(void* arg)
+{
+    struct duplex_link* link = arg;
+    uint8_t buf[4096];
+    size_t left = (size_t)DUPLEX_FRAMES * link->frame_size;
+    while (left) {
+        ssize_t ret = read(link->out[0], buf, left < sizeof(buf) ? left : sizeof(buf));
+        if (ret <= 0) return NULL;
+        left -= ret;
+    }
+    return NULL;
+}
+
+static void* duplex_receive(void* arg)
+{
+    struct duplex_link* link = arg;
+    while (link->handled < DUPLEX_FRAMES) {
+        uint32_t handled = link->handled;
+        cwake_poll(&link->platform);
+        if (handled == link->handled) sched_yield(); // no data, let peer run
+    }
+    return NULL;
+}
+
+static void* duplex_transmit(void* arg)
+{
+    struct duplex_link* link = arg;
+    for (int i = 0; i < DUPLEX_FRAMES; i++) {
+        while (cwake_call(0x01, 0x10, link->payload, sizeof(link->payload), &link->platform)) {
+            cwake_poll_tx(&link->platform);
+            sched_yield(); // port is full, let peer run
+        }
+    }
+    while (cwake_tx_pending(&link->platform)) {
+        cwake_poll_tx(&link->platform);
+        sched_yield();
+    }
+    return NULL;
+}
+
+// both directions served by one thread in turn (half-duplex mode)
+static void* duplex_alternate(void* arg)
+{
+    struct duplex_link* link = arg;
+    int sent = 0;
+    while (link->handled < DUPLEX_FRAMES || sent < DUPLEX_FRAMES ||
+           cwake_tx_pending(&link->platform)) {
+        uint32_t handled = link->handled;
+        int busy = 1;
+        if (sent < DUPLEX_FRAMES &&
+            !cwake_call(0x01, 0x10, link->payload, sizeof(link->payload), &link->platform)) {
+            sent += 1;
+            busy = 0;
+        }
+        cwake_poll(&link->platform);
+        if (link->handled >= DUPLEX_FRAMES) cwake_poll_tx(&link->platform);
+        if (busy && handled == link->handled) sched_yield();
+    }
+    return NULL;
+}
+
+// wall time of DUPLEX_FRAMES frames in selected directions
+static double duplex_run(struct duplex_link* link, uint8_t rx, uint8_t tx, uint8_t full_duplex)
+{
+    pthread_t threads[4];
+    int count = 0;
+
+    link->handled = rx ? 0 : DUPLEX_FRAMES;
+    link->platform.full_duplex = full_duplex;
+    cwake_init(&link->platform);
+
+    uint64_t start = time_now_ns();
+    if (rx) pthread_create(&threads[count++], NULL, duplex_feed, link);
+    if (tx) pthread_create(&threads[count++], NULL, duplex_drain, link);
+    if (full_duplex) {
+        if (rx) pthread_create(&threads[count++], NULL, duplex_receive, link);
+        if (tx) pthread_create(&threads[count++], NULL, duplex_transmit, link);
+    } else {
+        pthread_create(&threads[count++], NULL, duplex_alternate, link);
+    }
+    for (int i = 0; i < count; i++) pthread_join(threads[i], NULL);
+    return (time_now_ns() - start) / 1e9;
+}
+
+static void duplex_performance(void)
+{
+    static struct duplex_link link;
+
+    memset(&link, 0, sizeof(link));
+    if (pipe(link.in) || pipe(link.out)) {
+        log("Duplex: no pipes");
+        return;
+    }
+    fcntl(link.in[0], F_SETFL, O_NONBLOCK);
+    fcntl(link.out[1], F_SETFL, O_NONBLOCK);
+    for (size_t i = 0; i < sizeof(link.payload); i++) link.payload[i] = i;
+
+    platform = mock_create_cwake_platform(0x01, 5);
+    cwake_init(&platform);
+    cwake_call(0x01, 0x10, link.payload, sizeof(link.payload), &platform);
+    memcpy(link.frame, mock_tx_buffer, mock_tx_index);
+    link.frame_size = mock_tx_index;
+
+    link.platform = mock_create_cwake_platform(0x01, 1000);
+    link.platform.user = &link;
+    link.platform.read = duplex_read;
+    link.platform.write = duplex_write;
+    link.platform.handle = duplex_handle;
+
+    double mbytes = (double)DUPLEX_FRAMES * sizeof(link.payload) / 1048576.0;
+    double rx_only = duplex_run(&link, 1, 0, 1);
+    double tx_only = duplex_run(&link, 0, 1, 1);
+    double half = duplex_run(&link, 1, 1, 0);
+    double full = duplex_run(&link, 1, 1, 1);
+    log("Duplex: rx only %.2f MB/s, tx only %.2f MB/s", mbytes / rx_only, mbytes / tx_only);
+    log("Duplex: rx+tx half-duplex %.2f MB/s each, full-duplex %.2f MB/s each (x%.2f, %ld cores)",
+        mbytes / half, mbytes / full, half / full, sysconf(_SC_NPROCESSORS_ONLN));
+
+    close(link.in[0]);
+    close(link.in[1]);
+    close(link.out[0]);
+    close(link.out[1]);
+}
+#endif
+
+// Client and server platforms polled on own threads over a pair of real
+// file descriptors (pty, socketpair or pipes), so every frame costs the
+// syscalls and thread wake-ups of a real link
+struct fd_end {
+    int rd;
+    int wr;
+};
+
+struct roundtrip {
+    struct fd_end client_end;
+    struct fd_end server_end;
+    cwake_platform client;
+    cwake_platform server;
+    uint8_t payload[251];
+    uint16_t size;
+    uint32_t expected;      // frames server handles before it stops
+    uint32_t served;        // server thread
+    uint32_t responses;     // client thread
+    uint32_t stop;          // link stalled
+    uint64_t end_ns;        // time of last frame handled by server
+    uint64_t samples[ROUNDTRIP_CALLS];
+};
+
+static const uint16_t roundtrip_sizes[] = {1, 16, 64, 251};
+
+static uint32_t fd_end_read(void* user, uint8_t* buf, uint32_t count)
+{
+    ssize_t ret = read(((struct fd_end*)user)->rd, buf, count);
+    return ret > 0 ? ret : 0;
+}
+
+static uint32_t fd_end_write(void* user, uint8_t* buf, uint32_t count)
+{
+    ssize_t ret = write(((struct fd_end*)user)->wr, buf, count);
+    return ret > 0 ? ret : 0;
+}
+
+static int32_t roundtrip_response(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                                  uint8_t** rdata, uint16_t* rsize)
+{
+    ((struct roundtrip*)user)->responses += 1;
+    return 0;
+}
+
+static int32_t roundtrip_count(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                               uint8_t** rdata, uint16_t* rsize)
+{
+    struct roundtrip* loop = ctx;
+    loop->served += 1;
+    if (loop->served == loop->expected) loop->end_ns = time_now_ns();
+    return 0;
+}
+
+static int32_t roundtrip_echo(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                              uint8_t** rdata, uint16_t* rsize)
+{
+    roundtrip_count(ctx, cmd, data, size, rdata, rsize);
+    return suite_echo(ctx, cmd, data, size, rdata, rsize);
+}
+
+// sleep until end is readable (or writable while frames are queued), then
+// poll platform; 0 if nothing has come for ROUNDTRIP_STALL_MS
+static int roundtrip_wait(struct roundtrip* loop, struct fd_end* end, cwake_platform* platform)
+{
+    struct pollfd fds[2] = {{.fd = end->rd, .events = POLLIN}, {.fd = end->wr, .events = POLLOUT}};
+    nfds_t count = 1;
+
+    if (cwake_tx_pending(platform)) {
+        if (end->wr == end->rd) fds[0].events |= POLLOUT;
+        else count = 2;
+    }
+    if (poll(fds, count, ROUNDTRIP_STALL_MS) == 0 ||
+        __atomic_load_n(&loop->stop, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&loop->stop, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    cwake_poll_batch(platform, UINT32_MAX, NULL);
+    return 1;
+}
+
+static void* roundtrip_server(void* arg)
+{
+    struct roundtrip* loop = arg;
+    while (loop->served < loop->expected || cwake_tx_pending(&loop->server)) {
+        if (!roundtrip_wait(loop, &loop->server_end, &loop->server)) break;
+    }
+    return NULL;
+}
+
+// request after request, each one waits for its response
+static void* roundtrip_client(void* arg)
+{
+    struct roundtrip* loop = arg;
+
+    for (uint32_t i = 0; i < loop->expected; i++) {
+        uint64_t start = time_now_ns();
+        while (cwake_call(0x01, 0x10, loop->payload, loop->size, &loop->client)) {
+            if (!roundtrip_wait(loop, &loop->client_end, &loop->client)) return NULL;
+        }
+        while (loop->responses == i) {
+            if (!roundtrip_wait(loop, &loop->client_end, &loop->client)) return NULL;
+        }
+        if (i >= ROUNDTRIP_WARMUP) loop->samples[i - ROUNDTRIP_WARMUP] = time_now_ns() - start;
+    }
+    return NULL;
+}
+
+// frames sent as fast as the link takes them, server does not answer
+static void* roundtrip_stream(void* arg)
+{
+    struct roundtrip* loop = arg;
+
+    for (uint32_t i = 0; i < loop->expected; i++) {
+        while (cwake_call(0x01, 0x10, loop->payload, loop->size, &loop->client)) {
+            if (!roundtrip_wait(loop, &loop->client_end, &loop->client)) return NULL;
+        }
+    }
+    while (cwake_tx_pending(&loop->client)) {
+        if (!roundtrip_wait(loop, &loop->client_end, &loop->client)) return NULL;
+    }
+    return NULL;
+}
+
+// run client and server threads, wall time until server has all frames
+static double roundtrip_run(struct roundtrip* loop, void* (*client)(void*),
+                            cwake_handler handler, uint32_t frames)
+{
+    pthread_t threads[2];
+
+    loop->client = mock_create_cwake_platform(0x00, 1000);
+    loop->client.user = &loop->client_end;
+    loop->client.read = fd_end_read;
+    loop->client.write = fd_end_write;
+    loop->client.handle = roundtrip_response;
+    cwake_init(&loop->client);
+    loop->server = mock_create_cwake_platform(0x01, 1000);
+    loop->server.user = &loop->server_end;
+    loop->server.read = fd_end_read;
+    loop->server.write = fd_end_write;
+    cwake_init(&loop->server);
+    cwake_register_handler(&loop->server, 0x10, handler, loop, CWAKE_DATA_MAX);
+    loop->expected = frames;
+    loop->served = 0;
+    loop->responses = 0;
+    loop->stop = 0;
+
+    uint64_t start = time_now_ns();
+    pthread_create(&threads[0], NULL, roundtrip_server, loop);
+    pthread_create(&threads[1], NULL, client, loop);
+    pthread_join(threads[1], NULL);
+    pthread_join(threads[0], NULL);
+    return loop->served == frames ? (loop->end_ns - start) / 1e9 : 0;
+}
+
+static void roundtrip_close(struct roundtrip* loop)
+{
+    close(loop->client_end.rd);
+    close(loop->server_end.rd);
+    if (loop->client_end.wr != loop->client_end.rd) close(loop->client_end.wr);
+    if (loop->server_end.wr != loop->server_end.rd) close(loop->server_end.wr);
+}
+
+// open transport: 0 pty, 1 socketpair, 2 pipes; -1 if not available
+static int roundtrip_open(struct roundtrip* loop, int transport)
+{
+    int fds[4];
+
+    if (transport == 0) {
+        if (mock_pty_open(&fds[0], &fds[1], 1)) return -1;
+        loop->client_end = (struct fd_end){fds[0], fds[0]};
+        loop->server_end = (struct fd_end){fds[1], fds[1]};
+    } else if (transport == 1) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) return -1;
+        loop->client_end = (struct fd_end){fds[0], fds[0]};
+        loop->server_end = (struct fd_end){fds[1], fds[1]};
+    } else {
+        if (pipe(fds) || pipe(fds + 2)) return -1;
+        loop->client_end = (struct fd_end){fds[2], fds[1]};
+        loop->server_end = (struct fd_end){fds[0], fds[3]};
+    }
+    int ends[4] = {loop->client_end.rd, loop->client_end.wr,
+                   loop->server_end.rd, loop->server_end.wr};
+    for (int i = 0; i < 4; i++) fcntl(ends[i], F_SETFL, O_NONBLOCK);
+    return 0;
+}
+
+// Round-trip percentiles and one-way frame rate of two threads over pty,
+// socketpair and pipes
+static void roundtrip_performance(void)
+{
+    static struct roundtrip loop;
+    static const char* const names[] = {"pty", "socketpair", "pipe"};
+
+    for (int transport = 0; transport < 3; transport++) {
+        memset(&loop, 0, sizeof(loop));
+        if (roundtrip_open(&loop, transport)) {
+            log("Round trip %s: not available", names[transport]);
+            continue;
+        }
+        for (size_t n = 0; n < sizeof(roundtrip_sizes)/sizeof(roundtrip_sizes[0]); n++) {
+            if (roundtrip_sizes[n] > CWAKE_DATA_MAX) continue;
+            loop.size = roundtrip_sizes[n];
+            suite_payload(loop.payload, loop.size, PAYLOAD_RANDOM);
+
+            if (!roundtrip_run(&loop, roundtrip_client, roundtrip_echo,
+                               ROUNDTRIP_WARMUP + ROUNDTRIP_CALLS)) {
+                log("Round trip %s %3u B: LOST FRAMES", names[transport], loop.size);
+                break;
+            }
+            qsort(loop.samples, ROUNDTRIP_CALLS, sizeof(loop.samples[0]), compare_u64);
+            double seconds = roundtrip_run(&loop, roundtrip_stream, roundtrip_count,
+                                           ROUNDTRIP_STREAM);
+            if (!seconds) {
+                log("Round trip %s %3u B: LOST FRAMES", names[transport], loop.size);
+                break;
+            }
+            log("Round trip %s %3u B: p50 %.1f us, p90 %.1f us, p99 %.1f us, max %.1f us; stream %.0f frames/s (%.2f MB/s)",
+                names[transport], loop.size,
+                loop.samples[ROUNDTRIP_CALLS / 2] / 1e3,
+                loop.samples[ROUNDTRIP_CALLS * 90 / 100] / 1e3,
+                loop.samples[ROUNDTRIP_CALLS * 99 / 100] / 1e3,
+                loop.samples[ROUNDTRIP_CALLS - 1] / 1e3,
+                ROUNDTRIP_STREAM / seconds, ROUNDTRIP_STREAM * loop.size / seconds / 1048576.0);
+        }
+        roundtrip_close(&loop);
+    }
+}
+
+// Slaves emulated behind one socket end, request byte 0 is slave address.
+// Every request is answered ASYNC_DELAY_US later (device processing time).
+struct async_slaves {
+    int fd;                 // first member, platform user is used as int* too
+    cwake_platform platform;
+    uint64_t due[CWAKE_PENDING_MAX];
+    uint8_t addr[CWAKE_PENDING_MAX];
+    uint8_t cmd[CWAKE_PENDING_MAX];
+    uint32_t head;
+    uint32_t count;
+};
+
+static uint32_t async_completed = 0;
+
+static int32_t async_slave_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                                  uint8_t** rdata, uint16_t* rsize)
+{
+    struct async_slaves* slaves = user;
+    uint32_t tail = (slaves->head + slaves->count) % CWAKE_PENDING_MAX;
+    slaves->due[tail] = time_now_ns() + ASYNC_DELAY_US * 1000;
+    slaves->addr[tail] = data[0];
+    slaves->cmd[tail] = cmd;
+    slaves->count += 1;
+    return 0;
+}
+
+static void async_slaves_step(struct async_slaves* slaves)
+{
+    uint8_t response[16] = {0};
+    uint64_t now = time_now_ns();
+
+    cwake_poll_batch(&slaves->platform, UINT32_MAX, NULL);
+    while (slaves->count && slaves->due[slaves->head] <= now) {
+        uint32_t head = slaves->head;
+        cwake_call(slaves->addr[head], slaves->cmd[head], response, sizeof(response),
+                   &slaves->platform);
+        slaves->head = (head + 1) % CWAKE_PENDING_MAX;
+        slaves->count -= 1;
+    }
+}
+
+static void async_done(void* ctx, cwake_error err, const uint8_t* data, uint16_t size)
+{
+    async_completed += 1;
+}
+
+// wall time of ASYNC_CALLS calls with up to depth calls in flight
+static double async_run(cwake_platform* master, struct async_slaves* slaves, uint32_t depth)
+{
+    uint8_t request[16] = {0};
+    uint32_t sent = 0;
+
+    async_completed = 0;
+    uint64_t start = time_now_ns();
+    while (async_completed < ASYNC_CALLS) {
+        while (sent < ASYNC_CALLS && sent - async_completed < depth) {
+            request[0] = 1 + sent % depth;
+            if (cwake_call_async(request[0], 0x10, request, sizeof(request),
+                                 async_done, NULL, 1000, master)) break;
+            sent += 1;
+        }
+        async_slaves_step(slaves);
+        cwake_poll_batch(master, UINT32_MAX, NULL);
+    }
+    return (time_now_ns() - start) / 1e9;
+}
+
+static void async_performance(void)
+{
+    static struct async_slaves slaves;
+    int fds[2];
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+        log("Async: no socketpair");
+        return;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+
+    memset(&slaves, 0, sizeof(slaves));
+    slaves.fd = fds[1];
+    slaves.platform = mock_create_cwake_platform(0x00, 1000);
+    slaves.platform.user = &slaves;
+    slaves.platform.read = mock_fd_read;
+    slaves.platform.write = mock_fd_write;
+    slaves.platform.current_time_ms = mock_clock_ms;
+    slaves.platform.handle = async_slave_handle;
+    cwake_init(&slaves.platform);
+
+    platform = mock_create_cwake_platform(0x00, 1000);
+    platform.user = &fds[0];
+    platform.read = mock_fd_read;
+    platform.write = mock_fd_write;
+    platform.current_time_ms = mock_clock_ms;
+    cwake_init(&platform);
+
+    double lockstep = async_run(&platform, &slaves, 1);
+    double pipelined = async_run(&platform, &slaves, CWAKE_PENDING_MAX);
+    log("Async: lock-step %.0f calls/s, pipelined to %d slaves %.0f calls/s (x%.2f, %d us response delay)",
+        ASYNC_CALLS / lockstep, CWAKE_PENDING_MAX, ASYNC_CALLS / pipelined,
+        lockstep / pipelined, ASYNC_DELAY_US);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+#if CWAKE_HANDLERS
+// default handle of typical firmware: linear lookup in command table
+static uint32_t dispatch_hits[DISPATCH_COMMANDS];
+
+static int32_t dispatch_lookup(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                               uint8_t** rdata, uint16_t* rsize)
+{
+    static const uint8_t first = 0x10;
+    for (uint8_t i = 0; i < DISPATCH_COMMANDS; i++) {
+        if (first + i == cmd) {
+            dispatch_hits[i] += 1;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int32_t dispatch_direct(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                               uint8_t** rdata, uint16_t* rsize)
+{
+    *(uint32_t*)ctx += 1;
+    return 0;
+}
+
+// frames per second, small frames of all commands in turn
+static double dispatch_speed(void)
+{
+    uint32_t total = 0;
+
+    mock_rx_start = 0;
+    uint64_t start = time_now_ns();
+    while (total < DISPATCH_FRAMES) {
+        uint32_t frames = 0;
+        cwake_poll_batch(&platform, UINT32_MAX, &frames);
+        total += frames;
+    }
+    return total / ((time_now_ns() - start) / 1e9);
+}
+
+static void dispatch_performance(void)
+{
+    uint8_t data[2] = {1, 2};   // stream of all commands fits mock_rx_buffer
+
+    platform = mock_create_cwake_platform(0x01, 5);
+    platform.write = mock_write_append;
+    cwake_init(&platform);
+    mock_reset_buffers();
+    for (uint8_t i = 0; i < DISPATCH_COMMANDS; i++) {
+        cwake_call(0x01, 0x10 + i, data, sizeof(data), &platform);
+    }
+    memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+
     platform.read = mock_reread;
-    platform.handle = mock_dummy_handle;
+    platform.write = mock_dummy_rw;
+    platform.handle = dispatch_lookup;
     cwake_init(&platform);
+    double lookup = dispatch_speed();
 
-    //prepend packet for handling
-    cwake_call(FEND, FEND, packet, PACKET_SIZE, &platform);
+    platform.handle = NULL;
+    cwake_init(&platform);
+    for (uint8_t i = 0; i < DISPATCH_COMMANDS; i++) {
+        cwake_register_handler(&platform, 0x10 + i, dispatch_direct, &dispatch_hits[i], 0);
+    }
+    double table = dispatch_speed();
+    log("Dispatch: %d commands, linear lookup %.2f Mframes/s, table %.2f Mframes/s (x%.2f)",
+        DISPATCH_COMMANDS, lookup / 1e6, table / 1e6, table / lookup);
+}
+#endif
+
+// one slow command (waits for flash) among nine fast ones
+static int32_t pool_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                           uint8_t** rdata, uint16_t* rsize)
+{
+    static uint8_t response[4];
+    if (cmd == 0x30) {
+        struct timespec wait = {0, POOL_SLOW_US * 1000};
+        nanosleep(&wait, NULL);
+    }
+    *rdata = response;
+    *rsize = sizeof(response);
+    return 0;
+}
+
+// frames per second, slow command inline or on workers
+static double pool_speed(cwake_pool* pool, int8_t ordered)
+{
+    uint32_t total = 0;
+
+    cwake_init(&platform);
+    mock_rx_start = 0;
+    if (ordered >= 0) {
+        cwake_pool_start(pool, &platform, POOL_THREADS);
+        cwake_pool_register(pool, 0x30, pool_handle, NULL, ordered);
+    }
+    uint64_t start = time_now_ns();
+    while (total < POOL_FRAMES) {
+        uint32_t frames = 0;
+        if (ordered >= 0) cwake_pool_poll(pool, &frames);
+        else cwake_poll_batch(&platform, UINT32_MAX, &frames);
+        total += frames;
+    }
+    while (ordered >= 0 && cwake_pool_busy(pool)) {
+        cwake_pool_flush(pool);
+        sched_yield();
+    }
+    double speed = total / ((time_now_ns() - start) / 1e9);
+    if (ordered >= 0) cwake_pool_stop(pool);
+    return speed;
+}
+
+static void pool_performance(void)
+{
+    static cwake_pool pool;
+    uint8_t data[4] = {1, 2, 3, 4};
+
+    platform = mock_create_cwake_platform(0x01, 5);
+    platform.write = mock_write_append;
+    cwake_init(&platform);
+    mock_reset_buffers();
+    cwake_call(0x01, 0x30, data, sizeof(data), &platform);
+    for (int i = 0; i < 9; i++) cwake_call(0x01, 0x31, data, sizeof(data), &platform);
     memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
     mock_rx_index = mock_tx_index;
     mock_tx_index = 0;
 
-    double handle_duration;
-    double handle_speed;
-    handle_duration = measure_time(handle_packets);
-    handle_speed = (NUM_PACKETS * PACKET_SIZE) / handle_duration;
+    platform.read = mock_reread;
+    platform.write = mock_dummy_rw;
+    platform.handle = pool_handle;
+    double inline_speed = pool_speed(&pool, -1);
+    double ordered = pool_speed(&pool, 1);
+    double unordered = pool_speed(&pool, 0);
+    log("Pool: 10%% of frames take %d us, inline %.0f frames/s, %d workers ordered %.0f frames/s (x%.2f), unordered %.0f frames/s (x%.2f)",
+        POOL_SLOW_US, inline_speed, POOL_THREADS, ordered, ordered / inline_speed,
+        unordered, unordered / inline_speed);
+}
 
+// One direction of emulated link: written frames are delivered to the peer
+// after their transmission time at BULK_RATE and BULK_LATENCY_US.
+struct delay_line {
+    mock_link wire;             // delivered bytes
+    uint64_t line_free_ns;      // end of last transmission
+    uint32_t head;
+    uint32_t tail;
+    struct {
+        uint64_t due_ns;
+        uint32_t size;
+        uint8_t data[512];
+    } chunks[64];
+};
 
-    log("PERFORMANCE TEST COMPLETE");
+struct bulk_end {
+    mock_port port;             // in: wire of peer line (mock_port_read)
+    struct delay_line* out;
+};
+
+static uint32_t delay_write(void* user, uint8_t* buf, uint32_t count)
+{
+    struct delay_line* line = ((struct bulk_end*)user)->out;
+    uint32_t chunks = sizeof(line->chunks) / sizeof(line->chunks[0]);
+
+    if (line->head - line->tail == chunks || count > sizeof(line->chunks[0].data)) return 0;
+    uint64_t now = time_now_ns();
+    uint64_t start = line->line_free_ns > now ? line->line_free_ns : now;
+    line->line_free_ns = start + (uint64_t)count * 1000000000 / BULK_RATE;
 
-    // Convert to MB/s and Mb/s
-    double speed_MBps = send_speed / 1048576.0; // 1 MB = 2^20 bytes
-    double speed_Mbps = (send_speed * 8) / 1048576.0; // 1 bit = 1/8 byte
-    log("Packet creation speed: %.2f B/s, %.2f MB/s, %.2f Mb/s\n", send_speed, speed_MBps, speed_Mbps);
-    speed_MBps = handle_speed / 1048576.0; // 1 MB = 2^20 bytes
-    speed_Mbps = (handle_speed * 8) / 1048576.0; // 1 bit = 1/8 byte
-    log("Packet handling speed: %.2f B/s, %.2f MB/s, %.2f Mb/s\n", handle_speed, speed_MBps, speed_Mbps);
+    uint32_t i = line->head++ % chunks;
+    line->chunks[i].due_ns = line->line_free_ns + BULK_LATENCY_US * 1000;
+    line->chunks[i].size = count;
+    memcpy(line->chunks[i].data, buf, count);
+    return count;
 }
 
+static void delay_pump(struct delay_line* line)
+{
+    uint32_t chunks = sizeof(line->chunks) / sizeof(line->chunks[0]);
+    uint64_t now = time_now_ns();
+
+    while (line->tail != line->head && line->chunks[line->tail % chunks].due_ns <= now) {
+        uint32_t i = line->tail++ % chunks;
+        for (uint32_t b = 0; b < line->chunks[i].size; b++) {
+            line->wire.data[line->wire.head++ % sizeof(line->wire.data)] = line->chunks[i].data[b];
+        }
+    }
+}
+
+// goodput in bytes per second with selected window
+static uint32_t bulk_goodput(uint32_t window, uint32_t* resent)
+{
+    static struct delay_line to_slave;
+    static struct delay_line to_master;
+    static struct bulk_end master_end;
+    static struct bulk_end slave_end;
+    static cwake_platform slave;
+    static cwake_bulk sender;
+    static cwake_bulk receiver;
+    static uint8_t image[BULK_SIZE];
+    static uint8_t received[BULK_SIZE];
+
+    memset(&to_slave, 0, sizeof(to_slave));
+    memset(&to_master, 0, sizeof(to_master));
+    master_end.port.in = &to_master.wire;
+    master_end.out = &to_slave;
+    slave_end.port.in = &to_slave.wire;
+    slave_end.out = &to_master;
+
+    platform = mock_create_cwake_platform(0x00, 100);
+    platform.user = &master_end;
+    platform.read = mock_port_read;
+    platform.write = delay_write;
+    platform.current_time_ms = mock_clock_ms;
+    cwake_init(&platform);
+    slave = platform;
+    slave.addr = 0x01;
+    slave.user = &slave_end;
+    cwake_init(&slave);
+
+    cwake_bulk_init(&sender, &platform, 0x50, 100);
+    cwake_bulk_init(&receiver, &slave, 0x50, 100);
+    cwake_bulk_listen(&receiver, received, sizeof(received), NULL, NULL);
+    sender.window = window;
+    for (size_t i = 0; i < sizeof(image); i++) image[i] = i;
+
+    cwake_bulk_send(&sender, 0x01, image, sizeof(image));
+    while (cwake_bulk_poll(&sender) == CWAKE_ERROR_BUSY) {
+        delay_pump(&to_slave);
+        delay_pump(&to_master);
+        cwake_poll_batch(&slave, UINT32_MAX, NULL);
+        cwake_poll_batch(&platform, UINT32_MAX, NULL);
+    }
+    *resent = sender.tx_resent;
+    if (memcmp(image, received, sizeof(image))) return 0;
+    return cwake_bulk_goodput(&sender);
+}
+
+static void bulk_performance(void)
+{
+    uint32_t resent[2];
+    uint32_t stop_and_wait = bulk_goodput(1, &resent[0]);
+    uint32_t windowed = bulk_goodput(CWAKE_BULK_WINDOW, &resent[1]);
+
+    log("Bulk: %d KB over %d KB/s link with %d us latency: stop-and-wait %.1f KB/s, window %d %.1f KB/s (x%.2f, %u resent)",
+        BULK_SIZE / 1024, BULK_RATE / 1000, BULK_LATENCY_US, stop_and_wait / 1000.0,
+        CWAKE_BULK_WINDOW, windowed / 1000.0, (double)windowed / stop_and_wait,
+        resent[0] + resent[1]);
+}
+
+// payload bytes delivered to handler of receiving end
+static uint64_t ext_bytes = 0;
+
+static int32_t ext_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                          uint8_t** rdata, uint16_t* rsize)
+{
+    ext_bytes += size;
+    return 0;
+}
+
+// MB/s of payload sent in frames of chunk bytes and received back over
+// memory link, overhead is wire bytes per payload byte minus one
+static double ext_speed(uint8_t format, uint32_t chunk, double* overhead)
+{
+    static mock_link wire;
+    static uint8_t payload[EXT_SIZE];
+    static cwake_platform receiver;
+    mock_port port = {&wire, &wire};
+    uint64_t wire_bytes = 0;
+
+    memset(&wire, 0, sizeof(wire));
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = i;
+    platform = mock_create_cwake_platform(0x00, 5);
+    platform.user = &port;
+    platform.read = mock_port_read;
+    platform.write = mock_port_write;
+    platform.frame_format = format;
+    cwake_init(&platform);
+    receiver = platform;
+    receiver.addr = 0x01;
+    receiver.handle = ext_handle;
+    cwake_init(&receiver);
+
+    ext_bytes = 0;
+    uint64_t start = time_now_ns();
+    for (uint32_t round = 0; round < EXT_ROUNDS; round++) {
+        for (uint32_t offset = 0; offset < EXT_SIZE; offset += chunk) {
+            uint32_t size = EXT_SIZE - offset < chunk ? EXT_SIZE - offset : chunk;
+            uint32_t head = wire.head;
+            cwake_call(0x01, 0x30, payload + offset, size, &platform);
+            wire_bytes += wire.head - head;
+            while (wire.tail != wire.head) cwake_poll_batch(&receiver, UINT32_MAX, NULL);
+            cwake_poll_batch(&receiver, UINT32_MAX, NULL);
+        }
+    }
+    double seconds = (time_now_ns() - start) / 1e9;
+
+    *overhead = (double)wire_bytes / ((uint64_t)EXT_SIZE * EXT_ROUNDS) - 1;
+    if (ext_bytes != (uint64_t)EXT_SIZE * EXT_ROUNDS) return 0;
+    return (double)EXT_SIZE * EXT_ROUNDS / seconds / 1048576.0;
+}
+
+static void extended_performance(void)
+{
+    double overhead[3];
+    double classic = ext_speed(CWAKE_FRAME_CLASSIC, 251, &overhead[0]);
+    double crc16 = ext_speed(CWAKE_FRAME_CRC16, CWAKE_DATA_MAX, &overhead[1]);
+    double crc32 = ext_speed(CWAKE_FRAME_CRC32, CWAKE_DATA_MAX, &overhead[2]);
+
+    log("Extended: %d x %d KB payload, classic 251 B frames %.1f MB/s (%.2f%% overhead), %d B frames CRC-16 %.1f MB/s (%.2f%%), CRC-32 %.1f MB/s (%.2f%%)",
+        EXT_ROUNDS, EXT_SIZE / 1024, classic, overhead[0] * 100, CWAKE_DATA_MAX,
+        crc16, overhead[1] * 100, crc32, overhead[2] * 100);
+}
+
+// Frames sent over a noisy in-memory link (bit flips, lost and inserted
+// bytes in equal parts), receiver polled once per frame
+static struct {
+    mock_link to_slave;
+    mock_link to_master;
+    mock_port master_port;
+    mock_port slave_port;
+    cwake_platform master;
+    cwake_platform slave;
+    uint8_t payload[NOISE_PAYLOAD];
+    uint32_t delivered;     // frames received intact
+    uint32_t undetected;    // corrupted frames passed crc
+} noise;
+
+static const uint32_t noise_rates[] = {0, 100, 1000, 10000}; // errors per million bytes
+
+static int32_t noise_handle(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                            uint8_t** rdata, uint16_t* rsize)
+{
+    if (size == NOISE_PAYLOAD && !memcmp(data, noise.payload, size)) noise.delivered += 1;
+    else noise.undetected += 1;
+    return 0;
+}
+
+static void noise_performance(void)
+{
+    suite_payload(noise.payload, NOISE_PAYLOAD, PAYLOAD_RANDOM);
+    noise.master_port = (mock_port){&noise.to_master, &noise.to_slave};
+    noise.slave_port = (mock_port){&noise.to_slave, &noise.to_master};
+
+    for (size_t n = 0; n < sizeof(noise_rates)/sizeof(noise_rates[0]); n++) {
+        memset(&noise.to_slave, 0, sizeof(noise.to_slave));
+        memset(&noise.to_master, 0, sizeof(noise.to_master));
+        noise.to_slave.flip_ppm = noise_rates[n] / 3;
+        noise.to_slave.lose_ppm = noise_rates[n] / 3;
+        noise.to_slave.insert_ppm = noise_rates[n] / 3;
+        noise.master = mock_create_cwake_platform(0x00, 5);
+        noise.master.user = &noise.master_port;
+        noise.master.read = mock_port_read;
+        noise.master.write = mock_port_write;
+        cwake_init(&noise.master);
+        noise.slave = mock_create_cwake_platform(0x01, 5);
+        noise.slave.user = &noise.slave_port;
+        noise.slave.read = mock_port_read;
+        noise.slave.write = mock_port_write;
+        cwake_init(&noise.slave);
+        cwake_register_handler(&noise.slave, 0x10, noise_handle, NULL, CWAKE_DATA_MAX);
+        noise.delivered = 0;
+        noise.undetected = 0;
+
+        uint64_t start = time_now_ns();
+        for (uint32_t i = 0; i < NOISE_FRAMES; i++) {
+            cwake_call(0x01, 0x10, noise.payload, NOISE_PAYLOAD, &noise.master);
+            cwake_poll(&noise.slave);
+        }
+        cwake_poll_batch(&noise.slave, UINT32_MAX, NULL);
+        double seconds = (time_now_ns() - start) / 1e9;
+
+        uint32_t errors = noise.to_slave.errors;
+        uint32_t lost = NOISE_FRAMES - noise.delivered;
+        log("Noise %5u ppm: %4u errors, %4u frames lost (%.2f per error, %u undetected), goodput %.1f MB/s",
+            noise_rates[n], errors, lost, errors ? (double)lost / errors : 0.0, noise.undetected,
+            noise.delivered * NOISE_PAYLOAD / seconds / 1048576.0);
+    }
+}
+
+void cwake_lib_performance(void)
+{
+    log("PERFORMANCE TEST...");
+    log("Platform size: %u B (receive buffer %u B, CWAKE_DATA_MAX %u)",
+        (unsigned)sizeof(cwake_platform), (unsigned)CWAKE_RX_BUFFER_SIZE, (unsigned)CWAKE_DATA_MAX);
+
+    suite_performance();
+    crc_performance();
+#ifdef CWAKE_TEST
+    destuff_performance();
+    validate_performance();
+    framing_performance();
+#endif
+    batch_performance();
+    instances_performance();
+    hub_performance();
+#if CWAKE_FULL_DUPLEX
+    duplex_performance();
+#endif
+    roundtrip_performance();
+    async_performance();
+#if CWAKE_HANDLERS
+    dispatch_performance();
+#endif
+    pool_performance();
+    bulk_performance();
+    extended_performance();
+    noise_performance();
+    log("PERFORMANCE TEST COMPLETE");
+}
 
@@ -4,11 +4,15 @@
  * @author Qvafir <qvafir@outlook.com>
  * @copyright MIT License, see repository LICENSE file
  */
+#include <sched.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "cwake.h"
+#include "cwake_bulk.h"
+#include "cwake_hub.h"
+#include "cwake_pool.h"
 #include "mock.h"
 #include "common.h"
 
@@ -21,7 +25,7 @@ void cwake_debug_print(const char *format, ...){
     va_start(args, format);
     char msg[2042];
     vsnprintf(msg, sizeof(msg), format, args);
-    log(msg);
+    log("%s", msg);
     va_end(args);
 }
 
@@ -54,6 +58,642 @@ static void test_packet_formation() {
     log("PASSED");
 }
 
+static void test_fused_encoding() {
+    log("TEST fused encoding...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 1000);
+    cwake_init(&platform);
+
+    uint8_t data[256];
+    uint8_t frame[256];
+    uint8_t expect[512];
+    uint32_t seed = 0x9E3779B9;
+
+    for (int size = 0; size <= 251; size++) {
+        for (int i = 0; i < size; i++) {
+            seed = seed * 1103515245 + 12345;
+            data[i] = (seed & 0x30000) ? (uint8_t)(seed >> 24) : FEND;
+        }
+        // reference: frame copy, crc and stuffing as separate passes
+        frame[0] = FEND;
+        frame[1] = 0x01;
+        frame[2] = FESC;
+        frame[3] = size;
+        memcpy(frame + 4, data, size);
+        frame[4 + size] = get_crc8(frame, 4 + size, 0);
+        expect[0] = FEND;
+        size_t expect_len = 1 + stuff_scalar(frame + 1, 4 + size, expect + 1);
+
+        mock_reset_buffers();
+        cwake_error err = cwake_call(0x01, FESC, data, size, &platform);
+        ASSERT(err == CWAKE_ERROR_NONE);
+        ASSERT(mock_tx_index == expect_len);
+        ASSERT(!memcmp(expect, mock_tx_buffer, expect_len));
+    }
+    ASSERT(cwake_call(0x01, FESC, data, 252, &platform) == CWAKE_ERROR_INVALID_DATA);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static void test_scatter_gather() {
+    log("TEST scatter-gather...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 1000);
+    cwake_init(&platform);
+
+    uint8_t header[] = {0x01, FEND, 0x02, FESC};
+    uint8_t body[64];
+    uint8_t tail[] = {0x7F, FEND};
+    uint8_t joined[sizeof(header) + sizeof(body) + sizeof(tail)];
+    uint8_t expect[512];
+    uint32_t expect_len = 0;
+
+    for (size_t i = 0; i < sizeof(body); i++) body[i] = i; // escape-free
+    memcpy(joined, header, sizeof(header));
+    memcpy(joined + sizeof(header), body, sizeof(body));
+    memcpy(joined + sizeof(header) + sizeof(body), tail, sizeof(tail));
+
+    mock_reset_buffers();
+    cwake_error err = cwake_call(0x01, 0x20, joined, sizeof(joined), &platform);
+    ASSERT(err == CWAKE_ERROR_NONE);
+    memcpy(expect, mock_tx_buffer, mock_tx_index);
+    expect_len = mock_tx_index;
+
+    cwake_iovec parts[] = {
+        {header, sizeof(header)},
+        {body, sizeof(body)},
+        {tail, sizeof(tail)},
+    };
+
+    // write callback: one encoded buffer
+    mock_reset_buffers();
+    err = cwake_callv(0x01, 0x20, parts, 3, &platform);
+    ASSERT(err == CWAKE_ERROR_NONE);
+    ASSERT(mock_tx_index == expect_len);
+    ASSERT(!memcmp(expect, mock_tx_buffer, expect_len));
+
+    // writev callback: escape-free body is passed in place
+    platform.writev = mock_writev;
+    mock_reset_buffers();
+    err = cwake_callv(0x01, 0x20, parts, 3, &platform);
+    ASSERT(err == CWAKE_ERROR_NONE);
+    ASSERT(mock_writev_count == 3);
+    ASSERT(mock_writev_data[1] == body);
+    ASSERT(mock_tx_index == expect_len);
+    ASSERT(!memcmp(expect, mock_tx_buffer, expect_len));
+
+    // too large
+    cwake_iovec large[] = {{body, sizeof(body)}, {body, sizeof(body)},
+                           {body, sizeof(body)}, {body, sizeof(body)}};
+    err = cwake_callv(0x01, 0x20, large, 4, &platform);
+    ASSERT(err == CWAKE_ERROR_INVALID_DATA);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static void test_batch_transmit() {
+    log("TEST batch transmit...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 1000);
+    platform.write = mock_write_append;
+    cwake_init(&platform);
+
+    uint8_t data[] = {0x23, FESC, FEND, 0x3F};
+    uint8_t expect[512];
+    uint32_t expect_len = 0;
+
+    mock_reset_buffers();
+    for (int i = 0; i < 8; i++) {
+        cwake_error err = cwake_call(0x01, 0x10 + i, data, sizeof(data), &platform);
+        ASSERT(err == CWAKE_ERROR_NONE);
+    }
+    ASSERT(mock_write_count == 8);
+    memcpy(expect, mock_tx_buffer, mock_tx_index);
+    expect_len = mock_tx_index;
+
+    // 4 worst-case frames (17 bytes) fit into batch buffer
+    uint8_t batch[4*17];
+    mock_reset_buffers();
+    ASSERT(cwake_batch_begin(&platform, batch, sizeof(batch)) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_batch_begin(&platform, batch, sizeof(batch)) == CWAKE_ERROR_BUSY);
+    for (int i = 0; i < 8; i++) {
+        cwake_error err = cwake_call(0x01, 0x10 + i, data, sizeof(data), &platform);
+        ASSERT(err == CWAKE_ERROR_NONE);
+    }
+    ASSERT(mock_write_count == 1);
+    ASSERT(cwake_batch_flush(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(mock_write_count == 2);
+    ASSERT(mock_tx_index == expect_len);
+    ASSERT(!memcmp(expect, mock_tx_buffer, expect_len));
+
+    // frame larger than batch buffer is written directly
+    uint8_t small[8];
+    mock_reset_buffers();
+    ASSERT(cwake_batch_begin(&platform, small, sizeof(small)) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x01, 0x10, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(mock_write_count == 1);
+    ASSERT(cwake_batch_flush(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(mock_write_count == 1);
+    ASSERT(!memcmp(expect, mock_tx_buffer, mock_tx_index));
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+#if CWAKE_TX_QUEUE_SIZE
+static void test_tx_queue() {
+    log("TEST transmit queue...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 1000);
+    platform.write = mock_write_append;
+    cwake_init(&platform);
+
+    // enough frames of 251 bytes to fill queue and batch buffer
+    enum { FRAMES = (CWAKE_TX_QUEUE_SIZE + 2048) / 251 + 2 };
+    uint8_t data[251];
+    static uint8_t expect[FRAMES * 260];
+    uint32_t expect_len = 0;
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = i;
+
+    mock_reset_buffers();
+    for (int i = 0; i < FRAMES; i++) {
+        ASSERT(cwake_call(0x01, 0x10 + i, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    }
+    memcpy(expect, mock_tx_buffer, mock_tx_index);
+    expect_len = mock_tx_index;
+
+    // port accepts 7 bytes per write, the rest is written by cwake_poll
+    platform.write = mock_write_partial;
+    mock_reset_buffers();
+    mock_write_limit = 7;
+    ASSERT(cwake_call(0x01, 0x10, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(mock_tx_index == 7);
+    ASSERT(cwake_tx_pending(&platform) == expect_len / FRAMES - 7);
+    for (int i = 0; i < 100 && cwake_tx_pending(&platform); i++) {
+        ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    }
+    ASSERT(cwake_tx_pending(&platform) == 0);
+    ASSERT(mock_tx_index == expect_len / FRAMES);
+    ASSERT(!memcmp(expect, mock_tx_buffer, mock_tx_index));
+
+    // stalled port: full queue reports backpressure, frames keep order
+    mock_reset_buffers();
+    mock_write_limit = 0;
+    cwake_error err = CWAKE_ERROR_NONE;
+    int sent = 0;
+    while (sent < FRAMES && !err) {
+        err = cwake_call(0x01, 0x10 + sent, data, sizeof(data), &platform);
+        if (!err) sent += 1;
+    }
+    ASSERT(err == CWAKE_ERROR_BUSY);
+    ASSERT(sent > 0 && sent < FRAMES);
+    ASSERT(cwake_tx_pending(&platform) == sent * expect_len / FRAMES);
+    mock_write_limit = UINT32_MAX;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_tx_pending(&platform) == 0);
+    ASSERT(mock_tx_index == sent * expect_len / FRAMES);
+    ASSERT(!memcmp(expect, mock_tx_buffer, mock_tx_index));
+
+    // batch rest that does not fit into queue stays in batch buffer
+    static uint8_t batch[2048];
+    mock_reset_buffers();
+    mock_write_limit = 0;
+    ASSERT(cwake_batch_begin(&platform, batch, sizeof(batch)) == CWAKE_ERROR_NONE);
+    err = CWAKE_ERROR_NONE;
+    sent = 0;
+    while (sent < FRAMES && !err) {
+        err = cwake_call(0x01, 0x10 + sent, data, sizeof(data), &platform);
+        if (!err) sent += 1;
+    }
+    ASSERT(err == CWAKE_ERROR_BUSY);
+    ASSERT(cwake_batch_flush(&platform) == CWAKE_ERROR_BUSY);
+    mock_write_limit = UINT32_MAX;
+    ASSERT(cwake_batch_flush(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_tx_pending(&platform) == 0);
+    ASSERT(mock_tx_index == sent * expect_len / FRAMES);
+    ASSERT(!memcmp(expect, mock_tx_buffer, mock_tx_index));
+
+    pass_counter+=1;
+    log("PASSED");
+}
+#endif
+
+static uint8_t crc8_bitwise(const uint8_t* data, size_t size, uint8_t crc) {
+    for (size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ CRC8_POLYNOMIAL : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static void test_crc8() {
+    log("TEST crc8...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 1000);
+    cwake_init(&platform);
+
+    uint8_t data[1024];
+    uint32_t seed = 0x85EBCA6B;
+    for (size_t i = 0; i < sizeof(data); i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 16;
+    }
+
+    for (size_t size = 0; size <= 300; size++) {
+        for (int init = 0; init < 256; init += 51) {
+            ASSERT(cwake_crc8(data + size % 7, size, init) ==
+                   crc8_bitwise(data + size % 7, size, init));
+        }
+    }
+    ASSERT(cwake_crc8(data, sizeof(data), 0) == crc8_bitwise(data, sizeof(data), 0));
+    // chaining
+    ASSERT(cwake_crc8(data + 13, sizeof(data) - 13, cwake_crc8(data, 13, 0)) ==
+           cwake_crc8(data, sizeof(data), 0));
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static void test_stuffing_kernels() {
+    log("TEST stuffing kernels...");
+    total_counter+=1;
+
+    uint8_t src[256];
+    uint8_t expect[512];
+    uint8_t result[512];
+    uint32_t seed = 0x2545F491;
+
+    int best = select_kernels(KERNEL_AVX2);
+    for (int kernel = KERNEL_SCALAR; kernel <= best; kernel++) {
+        ASSERT(select_kernels(kernel) == kernel);
+
+        for (int pattern = 0; pattern < 4; pattern++) {
+            for (int len = 0; len < 256; len++) {
+                for (int i = 0; i < len; i++) {
+                    seed = seed * 1103515245 + 12345;
+                    uint8_t rnd = seed >> 16;
+                    switch (pattern) {
+                    case 0:  src[i] = FEND; break;
+                    case 1:  src[i] = (rnd & 1) ? FEND : FESC; break;
+                    case 2:  src[i] = rnd; break;
+                    default: src[i] = (rnd & 7) ? 0x55 : ((rnd & 8) ? FEND : FESC);
+                    }
+                }
+                size_t expect_len = 0;
+                if (len) {
+                    expect[0] = src[0];
+                    expect_len = 1 + stuff_scalar(src + 1, len - 1, expect + 1);
+                }
+                size_t result_len = stuff(src, len, result);
+                ASSERT(result_len == expect_len);
+                ASSERT(!memcmp(expect, result, expect_len));
+            }
+        }
+    }
+    select_kernels(KERNEL_AVX2);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static void test_destuffing_kernels() {
+    log("TEST destuffing kernels...");
+    total_counter+=1;
+
+    uint8_t src[256];
+    uint8_t encoded[512];
+    uint8_t expect[256];
+    uint8_t result[256];
+    uint32_t seed = 0x6C078965;
+
+    int best = select_kernels(KERNEL_AVX2);
+    for (int kernel = KERNEL_SCALAR; kernel <= best; kernel++) {
+        ASSERT(select_kernels(kernel) == kernel);
+
+        for (int pattern = 0; pattern < 5; pattern++) {
+            for (int len = 1; len < 256; len++) {
+                for (int i = 0; i < len; i++) {
+                    seed = seed * 1103515245 + 12345;
+                    uint8_t rnd = seed >> 16;
+                    switch (pattern) {
+                    case 0:  src[i] = FEND; break;
+                    case 1:  src[i] = rnd & 0x7F; break;
+                    case 2:  src[i] = rnd; break;
+                    default: src[i] = (rnd & 15) ? 0x55 : ((rnd & 16) ? FEND : FESC);
+                    }
+                }
+                size_t enc_len = stuff_scalar(src, len, encoded);
+                if (pattern == 4) {  // corrupted stream
+                    seed = seed * 1103515245 + 12345;
+                    encoded[(seed >> 16) % enc_len] = (seed & 1) ? FESC : 0x00;
+                }
+
+                size_t limits[] = {256, len, len - 1, len / 2};
+                for (size_t l = 0; l < sizeof(limits)/sizeof(limits[0]); l++) {
+                    size_t expect_len = destuff_scalar(encoded, enc_len, expect, limits[l]);
+                    size_t result_len = destuff(encoded, enc_len, result, limits[l]);
+                    ASSERT(result_len == expect_len);
+                    ASSERT(!memcmp(expect, result, expect_len));
+                    if (pattern != 4 && limits[l] >= (size_t)len) {
+                        ASSERT(result_len == (size_t)len);
+                    }
+                    // fused crc over decoded data
+                    uint8_t crc = 0x5A;
+                    result_len = destuff_crc8(encoded, enc_len, result, limits[l], &crc);
+                    ASSERT(result_len == expect_len);
+                    if (result_len) {
+                        ASSERT(crc == get_crc8(expect, result_len, 0x5A));
+                    }
+                }
+                // trailing FESC is incomplete sequence
+                encoded[enc_len] = FESC;
+                ASSERT(destuff(encoded, enc_len + 1, result, 256) == 0);
+            }
+        }
+    }
+    select_kernels(KERNEL_AVX2);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static void test_frame_scanning() {
+    log("TEST frame scanning...");
+    total_counter+=1;
+
+    uint8_t buf[512];
+    uint64_t map[512/64];
+    uint32_t seed = 0x1B873593;
+
+    int best = select_kernels(KERNEL_AVX2);
+    for (int kernel = KERNEL_SCALAR; kernel <= best; kernel++) {
+        ASSERT(select_kernels(kernel) == kernel);
+
+        for (size_t len = 0; len <= sizeof(buf); len += 7) {
+            for (size_t i = 0; i < sizeof(buf); i++) {
+                seed = seed * 1103515245 + 12345;
+                buf[i] = ((seed >> 16) & 3) ? (uint8_t)(seed >> 24) : FEND;
+            }
+            // scan region [start, start + len) in two parts (unaligned start)
+            size_t start = (len * 13) % (sizeof(buf) - len + 1);
+            size_t first = len / 3;
+            memset(map, 0xA5, sizeof(map));
+            scan_fend(buf, start, first, map);
+            scan_fend(buf, start + first, len - first, map);
+
+            size_t offset = 0;
+            for (size_t i = 0; i < len; i++) {
+                if (buf[start + i] != FEND) continue;
+                size_t found = find_fend(map, start + offset, len - offset);
+                ASSERT(offset + found == i);
+                offset = i + 1;
+            }
+            ASSERT(find_fend(map, start + offset, len - offset) == len - offset);
+        }
+    }
+    select_kernels(KERNEL_AVX2);
+
+    //=== many small frames in one chunk ===
+    cwake_platform platform = mock_create_cwake_platform(0x01, 10);
+    cwake_init(&platform);
+    mock_reset_buffers();
+
+    uint8_t data[] = {0x23, FESC, FEND, 0x3F};
+    uint8_t chunk[512];
+    uint32_t chunk_size = 0;
+    uint32_t frames = 0;
+    while (chunk_size + 16 < sizeof(chunk)) {
+        cwake_error err = cwake_call(0x01, 0x10, data, sizeof(data), &platform);
+        ASSERT(err == CWAKE_ERROR_NONE);
+        memcpy(chunk + chunk_size, mock_tx_buffer, mock_tx_index);
+        chunk_size += mock_tx_index;
+        frames += 1;
+    }
+    chunk[chunk_size++] = FEND; // trailing preamble is not an error
+    memcpy(mock_rx_buffer, chunk, chunk_size);
+    mock_rx_index = chunk_size;
+
+    handle_counter = 0;
+    int count = frames + 5;
+    while (count) {
+        count -= 1;
+        cwake_error err = cwake_poll(&platform);
+        ASSERT(err == CWAKE_ERROR_NONE);
+    }
+    ASSERT(handle_counter == frames);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static void test_batch_reception() {
+    log("TEST batch reception...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 10);
+    cwake_init(&platform);
+    mock_reset_buffers();
+
+    uint8_t data[] = {0x23, FESC, FEND, 0x3F};
+    uint8_t chunk[512];
+    uint32_t chunk_size = 0;
+    uint32_t bad_crc_pos = 0;
+    for (int i = 0; i < 20; i++) {
+        cwake_error err = cwake_call(0x01, 0x10 + i, data, sizeof(data), &platform);
+        ASSERT(err == CWAKE_ERROR_NONE);
+        memcpy(chunk + chunk_size, mock_tx_buffer, mock_tx_index);
+        chunk_size += mock_tx_index;
+        if (i == 11) bad_crc_pos = chunk_size - 2;
+    }
+    chunk[bad_crc_pos] ^= 0x01; // frame 11 is broken
+    memcpy(mock_rx_buffer, chunk, chunk_size);
+    mock_rx_index = chunk_size;
+
+    uint32_t handled = 0;
+    handle_counter = 0;
+    cwake_error err = cwake_poll_batch(&platform, 5, &handled);
+    ASSERT(err == CWAKE_ERROR_NONE);
+    ASSERT(handled == 5);
+    ASSERT(mock_called_cmd == 0x14);
+
+    // broken frame is skipped, frames behind it are handled by the same call
+    err = cwake_poll_batch(&platform, 100, &handled);
+    ASSERT(err == CWAKE_ERROR_CRC);
+    ASSERT(handled == 14);
+    ASSERT(handle_counter == 19);
+    ASSERT(mock_called_cmd == 0x10 + 19);
+
+    err = cwake_poll_batch(&platform, 100, &handled);
+    ASSERT(err == CWAKE_ERROR_NONE);
+    ASSERT(handled == 0);
+
+    err = cwake_poll_batch(&platform, 100, NULL);
+    ASSERT(err == CWAKE_ERROR_NONE);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+// append encoded frame of cmd to chunk
+static uint32_t resync_frame(cwake_platform* platform, uint8_t cmd,
+                             uint8_t* chunk, uint32_t chunk_size) {
+    uint8_t data[] = {0x23, FESC, FEND, 0x3F};
+    mock_tx_index = 0;
+    cwake_call(0x01, cmd, data, sizeof(data), platform);
+    memcpy(chunk + chunk_size, mock_tx_buffer, mock_tx_index);
+    return chunk_size + mock_tx_index;
+}
+
+static void test_resync() {
+    log("TEST resynchronization...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 10);
+    cwake_init(&platform);
+    mock_reset_buffers();
+    cwake_stats stats;
+    uint8_t chunk[256];
+    uint32_t chunk_size = 0;
+
+    //=== broken frame, implausible starts, then good frames ===
+    chunk_size = resync_frame(&platform, 0x20, chunk, chunk_size);
+    chunk[chunk_size - 2] ^= 0x01;
+    const uint8_t noise[] = {FEND, 0x01, 0x20, 0xFC, 0x55,      // size code out of range
+                             FEND, 0x01, 0x20, 0x10, 0x55,      // 16 bytes do not fit
+                             FEND, 0x01};                       // short header
+    memcpy(chunk + chunk_size, noise, sizeof(noise));
+    chunk_size += sizeof(noise);
+    chunk_size = resync_frame(&platform, 0x21, chunk, chunk_size);
+    chunk_size = resync_frame(&platform, 0x22, chunk, chunk_size);
+    memcpy(mock_rx_buffer, chunk, chunk_size);
+    mock_rx_index = chunk_size;
+    handle_counter = 0;
+
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_CRC);
+    ASSERT(handle_counter == 1 && mock_called_cmd == 0x21);
+    cwake_stats_snapshot(&platform, &stats);
+    ASSERT(stats.rx.crc_errors == 1);
+    ASSERT(stats.rx.invalid == 3);
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(handle_counter == 2 && mock_called_cmd == 0x22);
+
+    //=== FEND inserted into frame data, noise before first preamble ===
+    cwake_init(&platform);
+    mock_reset_buffers();
+    chunk[0] = 0x42;
+    chunk[1] = 0x42;
+    chunk_size = resync_frame(&platform, 0x23, chunk, 2);
+    memmove(chunk + 7, chunk + 6, chunk_size - 6);
+    chunk[6] = FEND;
+    chunk_size = resync_frame(&platform, 0x24, chunk, chunk_size + 1);
+    memcpy(mock_rx_buffer, chunk, chunk_size);
+    mock_rx_index = chunk_size;
+    handle_counter = 0;
+    mock_called_cmd = 0;
+
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_INVALID_DATA);
+    ASSERT(handle_counter == 1 && mock_called_cmd == 0x24);
+    ASSERT(platform.service.rx_tail == platform.service.rx_head);
+
+    //=== frame with lost byte is closed by preamble of next read ===
+    cwake_init(&platform);
+    mock_reset_buffers();
+    chunk_size = resync_frame(&platform, 0x25, chunk, 0);
+    memmove(chunk + 4, chunk + 5, chunk_size - 5);
+    uint32_t first_size = chunk_size - 1;
+    chunk_size = resync_frame(&platform, 0x26, chunk, first_size);
+    memcpy(mock_rx_buffer, chunk, chunk_size);
+    mock_rx_index = first_size;
+    handle_counter = 0;
+    mock_called_cmd = 0;
+
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(handle_counter == 0);
+    mock_rx_index = chunk_size;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_INVALID_DATA);
+    ASSERT(handle_counter == 1 && mock_called_cmd == 0x26);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static uint8_t stream[4096];
+static uint32_t stream_size = 0;
+static uint32_t stream_pos = 0;
+static uint32_t stream_chunk = 0;
+static uint32_t stream_chunk_max = 97;
+
+// read stream by chunks of varying size
+static uint32_t stream_read(void* user, uint8_t* buf, uint32_t count) {
+    uint32_t size = (stream_chunk * 7) % stream_chunk_max + 1;
+    stream_chunk += 1;
+    if (size > count) size = count;
+    if (size > stream_size - stream_pos) size = stream_size - stream_pos;
+    memcpy(buf, stream + stream_pos, size);
+    stream_pos += size;
+    return size;
+}
+
+static void test_ring_reception() {
+    log("TEST ring reception...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 10);
+    cwake_init(&platform);
+    mock_reset_buffers();
+
+    // frames of different size with escapes, split anywhere by reads
+    uint8_t data[64];
+    uint32_t frames = 0;
+    //extra preambles shift the stream against buffer end
+    const uint32_t shift_max = 4;
+    memset(stream, FEND, shift_max);
+    stream_size = shift_max;
+    while (stream_size + 2*sizeof(data) + 8 < sizeof(stream)) {
+        uint8_t size = frames % sizeof(data);
+        for (uint8_t i = 0; i < size; i++) data[i] = (i % 3) ? FESC + i : FEND;
+        cwake_error err = cwake_call(0x01, frames, data, size, &platform);
+        ASSERT(err == CWAKE_ERROR_NONE);
+        memcpy(stream + stream_size, mock_tx_buffer, mock_tx_index);
+        stream_size += mock_tx_index;
+        frames += 1;
+    }
+    platform.read = stream_read;
+
+    const uint32_t chunk_max[] = {97, 61, 13, 211, 512};
+    for (uint32_t n = 0; n < shift_max * sizeof(chunk_max)/sizeof(chunk_max[0]); n++) {
+        size_t c = n / shift_max;
+        cwake_init(&platform);
+        stream_pos = n % shift_max;
+        stream_chunk = 0;
+        stream_chunk_max = chunk_max[c];
+        handle_counter = 0;
+        mock_called_cmd = 0;
+
+        int count = stream_size + frames;
+        while (count) {
+            count -= 1;
+            cwake_error err = cwake_poll(&platform);
+            ASSERT(err == CWAKE_ERROR_NONE);
+        }
+        ASSERT(stream_pos == stream_size);
+        ASSERT(handle_counter == frames);
+        ASSERT(mock_called_cmd == (uint8_t)(frames - 1));
+    }
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
 static void test_packet_reception() {
     log("TEST packet reception...");
     total_counter+=1;
@@ -281,6 +921,472 @@ static void test_handler_return() {
     log("PASSED");
 }
 
+#if CWAKE_HANDLERS >= 2
+static uint32_t dispatch_calls[2];
+
+static int32_t dispatch_echo(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                             uint8_t** rdata, uint16_t* rsize) {
+    uint32_t* calls = ctx;
+    *calls += 1;
+    //write response into prepared buffer
+    memcpy(*rdata, data, size);
+    *rsize = size;
+    return 0;
+}
+
+static void test_handler_dispatch() {
+    log("TEST handler dispatch...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 10);
+    platform.write = mock_write_append;
+    cwake_init(&platform);
+
+    ASSERT(cwake_register_handler(&platform, 0x10, dispatch_echo, &dispatch_calls[0], 8) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_register_handler(&platform, 0x11, dispatch_echo, &dispatch_calls[1], 8) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_register_handler(&platform, 0x12, dispatch_echo, NULL, CWAKE_DATA_MAX + 1) == CWAKE_ERROR_INVALID_DATA);
+
+    //table holds CWAKE_HANDLERS commands, freed entries are reused
+    for (uint32_t i = 0; i + 2 < CWAKE_HANDLERS; i++) {
+        ASSERT(cwake_register_handler(&platform, 0x12 + i, dispatch_echo, NULL, 0) == CWAKE_ERROR_NONE);
+    }
+    ASSERT(cwake_register_handler(&platform, 0x0F, dispatch_echo, NULL, 0) == CWAKE_ERROR_BUSY);
+    ASSERT(cwake_register_handler(&platform, 0x11, dispatch_echo, &dispatch_calls[1], 8) == CWAKE_ERROR_NONE);
+    for (uint32_t i = 0; i + 2 < CWAKE_HANDLERS; i++) {
+        ASSERT(cwake_register_handler(&platform, 0x12 + i, NULL, NULL, 0) == CWAKE_ERROR_NONE);
+    }
+
+    //registered commands go to own handlers, others to default handle
+    mock_reset_buffers();
+    uint8_t data[] = {0x23, FESC, 0x7F, FEND};
+    ASSERT(cwake_call(0x01, 0x10, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x01, 0x11, data, 2, &platform) == CWAKE_ERROR_NONE);
+    uint32_t echo_size = mock_tx_index;
+    ASSERT(cwake_call(0x01, 0x20, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+
+    dispatch_calls[0] = 0;
+    dispatch_calls[1] = 0;
+    handle_counter = 0;
+    mock_called_cmd = 0;
+    uint32_t frames = 0;
+    ASSERT(cwake_poll_batch(&platform, UINT32_MAX, &frames) == CWAKE_ERROR_NONE);
+    ASSERT(frames == 3);
+    ASSERT(dispatch_calls[0] == 1 && dispatch_calls[1] == 1);
+    ASSERT(handle_counter == 1 && mock_called_cmd == 0x20);
+
+    //echo responses are the requests themselves
+    ASSERT(mock_tx_index == echo_size);
+    ASSERT(!memcmp(mock_tx_buffer, mock_rx_buffer, mock_tx_index));
+
+    //unregistered command returns to default handle
+    ASSERT(cwake_register_handler(&platform, 0x10, NULL, NULL, 0) == CWAKE_ERROR_NONE);
+    mock_rx_start = 0;
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+    ASSERT(cwake_poll_batch(&platform, UINT32_MAX, &frames) == CWAKE_ERROR_NONE);
+    ASSERT(frames == 2);
+    ASSERT(dispatch_calls[0] == 1 && dispatch_calls[1] == 2);
+    ASSERT(handle_counter == 2 && mock_called_cmd == 0x10);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+#endif
+
+#if CWAKE_FULL_DUPLEX
+static void test_full_duplex() {
+    log("TEST full duplex...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 10);
+    platform.full_duplex = 1;
+    platform.write = mock_write_append;
+    cwake_init(&platform);
+
+    uint8_t expect[] = {FEND, 0x01, 0xCF, strlen("Hello world!"),
+                        'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd', '!', 0};
+    expect[sizeof(expect)-1] = get_crc8(expect, sizeof(expect)-1, 0);
+
+    //two requests with response in one read
+    mock_reset_buffers();
+    uint8_t data[] = {0x23, FESC, 0x7F, 0x3F};
+    ASSERT(cwake_call(0x01, 0xCF, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x01, 0xCF, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+
+    //receiver does not write, next frame waits for transmitter
+    handle_counter = 0;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(handle_counter == 1);
+    ASSERT(mock_tx_index == 0);
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_BUSY);
+    ASSERT(handle_counter == 1);
+
+    ASSERT(cwake_poll_tx(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(mock_tx_index == sizeof(expect));
+    ASSERT(!memcmp(mock_tx_buffer, expect, sizeof(expect)));
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(handle_counter == 2);
+    ASSERT(cwake_poll_tx(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(mock_tx_index == 2 * sizeof(expect));
+
+    //receive timer expires while response is not taken (no deadline stays due)
+    mock_reset_buffers();
+    ASSERT(cwake_call(0x01, 0xCF, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+    mock_time_ms = 100;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    platform.service.start_pending_time = mock_time_ms;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_BUSY);
+    mock_time_ms += platform.timeout_ms + 1;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_TIMEOUT);
+    ASSERT(platform.service.start_pending_time == 0);
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_BUSY);
+    ASSERT(cwake_poll_tx(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(mock_tx_index == sizeof(expect));
+
+#if CWAKE_TX_QUEUE_SIZE
+    //queued transmit data is written by transmitter only
+    mock_reset_buffers();
+    platform.write = mock_write_partial;
+    mock_write_limit = 0;
+    ASSERT(cwake_call(0x01, 0x10, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    uint32_t pending = cwake_tx_pending(&platform);
+    ASSERT(pending > 0);
+    mock_write_limit = UINT32_MAX;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_tx_pending(&platform) == pending);
+    ASSERT(cwake_poll_tx(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_tx_pending(&platform) == 0);
+    ASSERT(mock_tx_index == pending);
+#endif
+
+    pass_counter+=1;
+    log("PASSED");
+}
+#endif
+
+struct async_result {
+    cwake_error err;
+    uint32_t count;
+    uint8_t size;
+    uint8_t data[4];
+};
+
+static void async_done(void* ctx, cwake_error err, const uint8_t* data, uint16_t size) {
+    struct async_result* result = ctx;
+    result->err = err;
+    result->count += 1;
+    result->size = size;
+    if (size) memcpy(result->data, data, size < sizeof(result->data) ? size : sizeof(result->data));
+}
+
+static void test_async_call() {
+    log("TEST async call...");
+    total_counter+=1;
+
+    cwake_platform master = mock_create_cwake_platform(0x00, 10);
+    master.write = mock_write_append;
+    cwake_init(&master);
+    //slave only encodes responses
+    cwake_platform slave = mock_create_cwake_platform(0x00, 10);
+    slave.write = mock_write_append;
+    cwake_init(&slave);
+
+    //three calls in flight, same (addr, cmd) can not be pipelined
+    mock_reset_buffers();
+    mock_time_ms = 100;
+    struct async_result results[3];
+    memset(results, 0, sizeof(results));
+    uint8_t data[] = {0x11, FEND};
+    ASSERT(cwake_call_async(0x01, 0x10, data, sizeof(data), async_done, &results[0], 20, &master) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call_async(0x02, 0x10, data, sizeof(data), async_done, &results[1], 20, &master) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call_async(0x01, 0x11, data, sizeof(data), async_done, &results[2], 50, &master) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call_async(0x01, 0x10, data, sizeof(data), async_done, &results[0], 20, &master) == CWAKE_ERROR_BUSY);
+    ASSERT(cwake_call_async(0x03, 0x10, data, sizeof(data), NULL, NULL, 20, &master) == CWAKE_ERROR_INVALID_DATA);
+    ASSERT(master.service.pending_count == 3);
+
+    //responses arrive out of order and bypass handler
+    mock_tx_index = 0;
+    uint8_t reply[] = {0xA5, FESC};
+    ASSERT(cwake_call(0x01, 0x11, reply, sizeof(reply), &slave) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x02, 0x10, reply, 1, &slave) == CWAKE_ERROR_NONE);
+    memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+    handle_counter = 0;
+    ASSERT(cwake_poll(&master) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_poll(&master) == CWAKE_ERROR_NONE);
+    ASSERT(handle_counter == 0);
+    ASSERT(mock_tx_index == 0);
+    ASSERT(results[2].count == 1 && results[2].err == CWAKE_ERROR_NONE);
+    ASSERT(results[2].size == sizeof(reply) && !memcmp(results[2].data, reply, sizeof(reply)));
+    ASSERT(results[1].count == 1 && results[1].size == 1 && results[1].data[0] == 0xA5);
+    ASSERT(results[0].count == 0);
+
+    //unanswered call expires
+    mock_time_ms = 119;
+    ASSERT(cwake_poll(&master) == CWAKE_ERROR_NONE);
+    ASSERT(results[0].count == 0);
+    mock_time_ms = 120;
+    ASSERT(cwake_poll(&master) == CWAKE_ERROR_NONE);
+    ASSERT(results[0].count == 1 && results[0].err == CWAKE_ERROR_TIMEOUT);
+    ASSERT(master.service.pending_count == 0);
+
+    //table is full
+    for (uint32_t i = 0; i < CWAKE_PENDING_MAX; i++) {
+        ASSERT(cwake_call_async(0x01, i, data, sizeof(data), async_done, &results[0], 5, &master) == CWAKE_ERROR_NONE);
+    }
+    ASSERT(cwake_call_async(0x01, 0x7F, data, sizeof(data), async_done, &results[0], 5, &master) == CWAKE_ERROR_BUSY);
+    mock_time_ms += 5;
+    ASSERT(cwake_poll(&master) == CWAKE_ERROR_NONE);
+    ASSERT(results[0].count == 1 + CWAKE_PENDING_MAX);
+    ASSERT(master.service.pending_count == 0);
+
+    //not available in full-duplex mode
+    master.full_duplex = 1;
+    ASSERT(cwake_call_async(0x01, 0x10, data, sizeof(data), async_done, &results[0], 5, &master) == CWAKE_ERROR_INVALID_DATA);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static uint8_t ext_received[CWAKE_DATA_MAX];
+static uint32_t ext_received_size = 0;
+
+// slave echoes request, master stores response
+static int32_t ext_echo(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                        uint8_t** rdata, uint16_t* rsize) {
+    if (*rdata) {
+        memcpy(*rdata, data, size);
+        *rsize = size;
+    }
+    memcpy(ext_received, data, size);
+    ext_received_size = size;
+    return 0;
+}
+
+// poll until one frame is handled or error
+static cwake_error ext_poll(cwake_platform* platform) {
+    cwake_error err = CWAKE_ERROR_NONE;
+    uint32_t handled = 0;
+    for (int i = 0; i < 100 && !err && !handled; i++) {
+        err = cwake_poll_batch(platform, 1, &handled);
+    }
+    return err;
+}
+
+static void test_extended_frames() {
+    log("TEST extended frames...");
+    total_counter+=1;
+
+    //check values of CRC-16/CCITT-FALSE and CRC-32
+    const uint8_t check[] = "123456789";
+    ASSERT(cwake_crc16(check, 9, 0xFFFF) == 0x29B1);
+    ASSERT(cwake_crc32(check, 9, 0) == 0xCBF43926);
+    ASSERT(cwake_crc32(check + 4, 5, cwake_crc32(check, 4, 0)) == 0xCBF43926);
+
+    //wire format: flag in place of N, length and crc little-endian
+    cwake_platform platform = mock_create_cwake_platform(0x01, 10);
+    platform.frame_format = CWAKE_FRAME_CRC16;
+    cwake_init(&platform);
+    mock_reset_buffers();
+    uint8_t small[] = {0x11, 0x22};
+    ASSERT(cwake_call(0x01, 0x10, small, sizeof(small), &platform) == CWAKE_ERROR_NONE);
+    uint8_t expect[] = {FEND, 0x01, 0x10, 0xFE, 0x02, 0x00, 0x11, 0x22};
+    uint16_t crc = cwake_crc16(expect, sizeof(expect), 0xFFFF);
+    ASSERT(mock_tx_index >= sizeof(expect) + 2);
+    ASSERT(!memcmp(mock_tx_buffer, expect, sizeof(expect)));
+    if (mock_tx_index == sizeof(expect) + 2) {
+        ASSERT(mock_tx_buffer[8] == (crc & 0xFF) && mock_tx_buffer[9] == crc >> 8);
+    }
+
+    static mock_link to_slave;
+    static mock_link to_master;
+    static uint8_t payload[CWAKE_DATA_MAX + 1];
+    mock_port master_port = {&to_master, &to_slave};
+    mock_port slave_port = {&to_slave, &to_master};
+    memset(&to_slave, 0, sizeof(to_slave));
+    memset(&to_master, 0, sizeof(to_master));
+    for (size_t i = 0; i < sizeof(payload); i++) payload[i] = i * 7; // FEND, FESC
+
+    cwake_platform master = mock_create_cwake_platform(0x00, 10);
+    master.user = &master_port;
+    master.read = mock_port_read;
+    master.write = mock_port_write;
+    master.frame_format = CWAKE_FRAME_CRC32;
+    cwake_init(&master);
+    cwake_platform slave = mock_create_cwake_platform(0x01, 10);
+    slave.user = &slave_port;
+    slave.read = mock_port_read;
+    slave.write = mock_port_write;
+    cwake_init(&slave);
+    ASSERT(cwake_register_handler(&master, 0x20, ext_echo, NULL, 0) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_register_handler(&slave, 0x20, ext_echo, NULL, CWAKE_DATA_MAX) == CWAKE_ERROR_NONE);
+
+    //largest frame, classic slave responds in format of request
+    uint8_t formats[] = {CWAKE_FRAME_CRC32, CWAKE_FRAME_CRC16};
+    for (int f = 0; f < 2; f++) {
+        master.frame_format = formats[f];
+        ext_received_size = 0;
+        ASSERT(cwake_call(0x01, 0x20, payload, CWAKE_DATA_MAX, &master) == CWAKE_ERROR_NONE);
+        ASSERT(ext_poll(&slave) == CWAKE_ERROR_NONE);
+        ASSERT(ext_received_size == CWAKE_DATA_MAX);
+        ASSERT(to_master.data[(to_master.tail + 3) % sizeof(to_master.data)] ==
+               (formats[f] == CWAKE_FRAME_CRC16 ? 0xFE : 0xFF));
+        ext_received_size = 0;
+        ASSERT(ext_poll(&master) == CWAKE_ERROR_NONE);
+        ASSERT(ext_received_size == CWAKE_DATA_MAX);
+        ASSERT(!memcmp(ext_received, payload, CWAKE_DATA_MAX));
+    }
+
+    //frames over limit of format are not sent
+    ASSERT(cwake_call(0x01, 0x20, payload, CWAKE_DATA_MAX + 1, &master) == CWAKE_ERROR_INVALID_DATA);
+    master.frame_format = CWAKE_FRAME_CLASSIC;
+    ASSERT(cwake_call(0x01, 0x20, payload, 252, &master) == CWAKE_ERROR_INVALID_DATA);
+    ASSERT(to_slave.head == to_slave.tail);
+
+    //corrupted data byte
+    master.frame_format = CWAKE_FRAME_CRC32;
+    ASSERT(cwake_call(0x01, 0x20, payload + 1, 16, &master) == CWAKE_ERROR_NONE);
+    to_slave.data[(to_slave.tail + 7) % sizeof(to_slave.data)] ^= 0x01;
+    ASSERT(ext_poll(&slave) == CWAKE_ERROR_CRC);
+
+    //length over CWAKE_DATA_MAX
+    uint8_t header[] = {FEND, 0x01, 0x20, 0xFF,
+                        (CWAKE_DATA_MAX + 1) & 0xFF, (CWAKE_DATA_MAX + 1) >> 8, 0x00, FEND};
+    ASSERT(mock_port_write(&master_port, header, sizeof(header)) == sizeof(header));
+    ASSERT(ext_poll(&slave) == CWAKE_ERROR_INVALID_DATA);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static uint32_t bulk_received_size = 0;
+
+static void bulk_received(void* ctx, const uint8_t* data, uint32_t size) {
+    bulk_received_size = size;
+}
+
+// run both link ends until transfer ends, time goes 1 ms per round
+static cwake_error bulk_run(cwake_bulk* sender, cwake_platform* master, cwake_platform* slave) {
+    cwake_error status = CWAKE_ERROR_BUSY;
+    for (int i = 0; i < 1000 && status == CWAKE_ERROR_BUSY; i++) {
+        status = cwake_bulk_poll(sender);
+        cwake_poll_batch(slave, UINT32_MAX, NULL);
+        cwake_poll_batch(master, UINT32_MAX, NULL);
+        mock_time_ms += 1;
+    }
+    return status;
+}
+
+static void test_bulk_transfer() {
+    log("TEST bulk transfer...");
+    total_counter+=1;
+
+    static mock_link to_slave;
+    static mock_link to_master;
+    static uint8_t image[3000];
+    static uint8_t received[4096];
+    mock_port master_port = {&to_master, &to_slave};
+    mock_port slave_port = {&to_slave, &to_master};
+    memset(&to_slave, 0, sizeof(to_slave));
+    memset(&to_master, 0, sizeof(to_master));
+    for (size_t i = 0; i < sizeof(image); i++) image[i] = i * 7;
+
+    cwake_platform master = mock_create_cwake_platform(0x00, 10);
+    master.user = &master_port;
+    master.read = mock_port_read;
+    master.write = mock_port_write;
+    cwake_init(&master);
+    cwake_platform slave = mock_create_cwake_platform(0x01, 10);
+    slave.user = &slave_port;
+    slave.read = mock_port_read;
+    slave.write = mock_port_write;
+    cwake_init(&slave);
+
+    cwake_bulk sender;
+    cwake_bulk receiver;
+    mock_time_ms = 100;
+#if CWAKE_BULK_FRAGMENT + 4 > 251
+    master.frame_format = CWAKE_FRAME_CRC16;
+#endif
+    ASSERT(cwake_bulk_init(&sender, &master, 0x50, 20) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_bulk_init(&receiver, &slave, 0x50, 20) == CWAKE_ERROR_NONE);
+    cwake_bulk_listen(&receiver, received, sizeof(received), bulk_received, NULL);
+    sender.window = 4;
+
+    //larger than one frame, fragments beyond window wait for acknowledges
+    ASSERT(cwake_bulk_send(&sender, 0x01, image, sizeof(image)) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_bulk_send(&sender, 0x01, image, sizeof(image)) == CWAKE_ERROR_BUSY);
+    ASSERT(cwake_bulk_poll(&sender) == CWAKE_ERROR_BUSY);
+    ASSERT(to_slave.writes == 4);
+    ASSERT(bulk_run(&sender, &master, &slave) == CWAKE_ERROR_NONE);
+    ASSERT(bulk_received_size == sizeof(image));
+    ASSERT(!memcmp(received, image, sizeof(image)));
+    ASSERT(sender.tx_resent == 0);
+    ASSERT(cwake_bulk_goodput(&sender) > 0);
+
+    //lost fragment and lost acknowledge are sent again after timeout
+    memset(received, 0, sizeof(received));
+    bulk_received_size = 0;
+    to_slave.writes = 0;
+    to_slave.drop = 3;
+    to_master.writes = 0;
+    to_master.drop = 6;
+    ASSERT(cwake_bulk_send(&sender, 0x01, image, sizeof(image)) == CWAKE_ERROR_NONE);
+    ASSERT(bulk_run(&sender, &master, &slave) == CWAKE_ERROR_NONE);
+    ASSERT(bulk_received_size == sizeof(image));
+    ASSERT(!memcmp(received, image, sizeof(image)));
+    ASSERT(sender.tx_resent > 0);
+
+    //restarted sender reuses id of completed transfer
+    to_slave.drop = 0;
+    to_master.drop = 0;
+    image[0] ^= 0xFF;
+    bulk_received_size = 0;
+    sender.tx_id = receiver.rx_id - 1;
+    ASSERT(cwake_bulk_send(&sender, 0x01, image, sizeof(image)) == CWAKE_ERROR_NONE);
+    ASSERT(sender.tx_id == receiver.rx_id);
+    ASSERT(bulk_run(&sender, &master, &slave) == CWAKE_ERROR_NONE);
+    ASSERT(bulk_received_size == sizeof(image));
+    ASSERT(!memcmp(received, image, sizeof(image)));
+
+    //transfer larger than reassembly buffer is not acknowledged
+    to_slave.drop = 0;
+    to_master.drop = 0;
+    cwake_bulk_listen(&receiver, received, 1000, bulk_received, NULL);
+    ASSERT(cwake_bulk_send(&sender, 0x01, image, sizeof(image)) == CWAKE_ERROR_NONE);
+    ASSERT(bulk_run(&sender, &master, &slave) == CWAKE_ERROR_TIMEOUT);
+    ASSERT(cwake_bulk_goodput(&sender) == 0);
+
+    //short fragment which is not the last one is not acknowledged
+    uint8_t short_fragment[] = {0x01, 0x77, 0x00, 0x00, 0xAA, 0xBB};
+    to_master.writes = 0;
+    ASSERT(cwake_call(0x01, 0x50, short_fragment, sizeof(short_fragment), &master) == CWAKE_ERROR_NONE);
+    ASSERT(bulk_run(&sender, &master, &slave) == CWAKE_ERROR_TIMEOUT);
+    ASSERT(to_master.writes == 0);
+    ASSERT(receiver.rx_id != 0x77);
+
+#if CWAKE_BULK_FRAGMENT + 4 > 251
+    //fragment larger than classic frame fails transfer at once
+    master.frame_format = CWAKE_FRAME_CLASSIC;
+    ASSERT(cwake_bulk_send(&sender, 0x01, image, sizeof(image)) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_bulk_poll(&sender) == CWAKE_ERROR_INVALID_DATA);
+    ASSERT(cwake_bulk_poll(&sender) == CWAKE_ERROR_INVALID_DATA);
+#endif
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
 static void test_timeout() {
     log("TEST timeout...");
     total_counter+=1;
@@ -308,14 +1414,409 @@ static void test_timeout() {
     log("PASSED");
 }
 
-void cwake_lib_test(void) {
+static uint32_t stats_clock_us = 0;
+
+static uint32_t stats_time_us(void* user) {
+    return stats_clock_us;
+}
+
+// every handler call takes 100 us
+static int32_t stats_handle(void* user, uint8_t cmd, uint8_t* data, uint16_t size,
+                            uint8_t** rdata, uint16_t* rsize) {
+    stats_clock_us += 100;
+    return mock_handle(user, cmd, data, size, rdata, rsize);
+}
+
+static void test_stats() {
+    log("TEST stats...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 5);
+    platform.current_time_us = stats_time_us;
+    platform.handle = stats_handle;
+    cwake_init(&platform);
+    mock_reset_buffers();
+    cwake_stats stats;
+
+    //=== transmitted frames ===
+    uint8_t data[] = {0x23, FESC, FEND, 0x3F};
+    const uint8_t addr[] = {0x01, 0x01, 0x02};
+    uint8_t chunk[128];
+    uint32_t chunk_size = 0;
+    uint32_t second = 0;
+    for (int i = 0; i < 3; i++) {
+        if (i == 1) second = chunk_size;
+        ASSERT(cwake_call(addr[i], 0xCF, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+        memcpy(chunk + chunk_size, mock_tx_buffer, mock_tx_index);
+        chunk_size += mock_tx_index;
+    }
+    const uint32_t unstuffed = 3 * (PREAMBLE_SIZE + HEADER_SIZE + sizeof(data) + CRC_SIZE);
+    cwake_stats_snapshot(&platform, &stats);
+    ASSERT(stats.tx.frames == 3);
+    ASSERT(stats.tx.bytes == chunk_size);
+    ASSERT(stats.tx.escapes == chunk_size - unstuffed);
+    ASSERT(stats.rx.frames == 0);
+
+    //=== received: valid frame, broken crc, other address ===
+    cwake_stats_reset(&platform);
+    chunk[second + 4] ^= 0x01; // first data byte of second frame
+    memcpy(mock_rx_buffer, chunk, chunk_size);
+    mock_rx_index = chunk_size;
+    mock_tx_index = 0;
+    stats_clock_us = 1000;
+
+    uint32_t crc_errors = 0;
+    for (int i = 0; i < 5; i++) {
+        cwake_error err = cwake_poll(&platform);
+        ASSERT(err == CWAKE_ERROR_NONE || err == CWAKE_ERROR_CRC);
+        crc_errors += err == CWAKE_ERROR_CRC;
+    }
+    ASSERT(crc_errors == 1);
+    cwake_stats_snapshot(&platform, &stats);
+    ASSERT(stats.rx.bytes == chunk_size);
+    ASSERT(stats.rx.escapes == chunk_size - unstuffed);
+    ASSERT(stats.rx.frames == 2);
+    ASSERT(stats.rx.filtered == 1);
+    ASSERT(stats.rx.crc_errors == 1);
+    ASSERT(stats.rx.handled == 1);
+    ASSERT(stats.rx.handler_us == 100);
+    ASSERT(stats.rx.handler_hist[7] == 1);          // 64 .. 127 us
+    ASSERT(stats.rx.turnaround_hist[7] == 1);       // response after handler
+    ASSERT(stats.tx.frames == 1);
+    ASSERT(stats.tx.bytes == mock_tx_index);
+
+    //=== invalid size code and timeout ===
+    const uint8_t invalid[] = {FEND, 0x01, 0xCF, 0xFC, FEND, 0x01, 0xCF};
+    memcpy(mock_rx_buffer, invalid, sizeof(invalid));
+    mock_rx_index = sizeof(invalid);
+    mock_rx_start = 0;
+    mock_time_ms = 1; // timer of open frame starts in the same call (0: not started)
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_INVALID_DATA);
+    cwake_error err = CWAKE_ERROR_NONE;
+    for (int i = 0; i < 15 && err == CWAKE_ERROR_NONE; i++) {
+        mock_time_ms += 1;
+        err = cwake_poll(&platform);
+    }
+    ASSERT(err == CWAKE_ERROR_TIMEOUT);
+    cwake_stats_snapshot(&platform, &stats);
+    ASSERT(stats.rx.invalid == 1);
+    ASSERT(stats.rx.timeouts == 1);
+
+    cwake_stats_reset(&platform);
+    cwake_stats_snapshot(&platform, &stats);
+    ASSERT(stats.rx.frames == 0 && stats.rx.handler_hist[7] == 0 && stats.tx.frames == 0);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+#ifdef CWAKE_TRACE
+static void test_trace() {
+    log("TEST trace...");
+    total_counter+=1;
+
+    cwake_platform platform = mock_create_cwake_platform(0x01, 5);
+    platform.current_time_us = stats_time_us;
+    cwake_init(&platform);
+    mock_reset_buffers();
+    cwake_trace_event events[CWAKE_TRACE_EVENTS];
+    uint8_t data[CWAKE_TRACE_BYTES + 8];
+    for (uint32_t i = 0; i < sizeof(data); i++) data[i] = i;
+    stats_clock_us = 500;
+
+    //=== transmitted frame: size is kept, data is cut ===
+    ASSERT(cwake_call(0x02, 0xCF, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_trace_dump(&platform, events, CWAKE_TRACE_EVENTS) == 1);
+    ASSERT(events[0].seq == 1 && events[0].stage == CWAKE_TRACE_TX);
+    ASSERT(events[0].time_us == 500);
+    ASSERT(events[0].size == mock_tx_index);
+    ASSERT(memcmp(events[0].data, mock_tx_buffer, CWAKE_TRACE_BYTES) == 0);
+
+    //=== received chunk, frame to other address, broken crc ===
+    uint32_t frame_size = mock_tx_index;
+    memcpy(mock_rx_buffer, mock_tx_buffer, frame_size);
+    memcpy(mock_rx_buffer + frame_size, mock_tx_buffer, frame_size);
+    mock_rx_buffer[frame_size + 4] ^= 0x01;
+    mock_rx_index = 2 * frame_size;
+    mock_tx_index = 0;
+    stats_clock_us = 700;
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_poll(&platform) == CWAKE_ERROR_CRC);
+
+    ASSERT(cwake_trace_dump(&platform, events, CWAKE_TRACE_EVENTS) == 4);
+    ASSERT(events[1].stage == CWAKE_TRACE_RX && events[1].size == 2 * frame_size);
+    ASSERT(events[1].time_us == 700);
+    ASSERT(events[2].stage == CWAKE_TRACE_FRAME);
+    ASSERT(events[2].size == HEADER_SIZE + sizeof(data));
+    ASSERT(events[2].data[ADDR_POS] == 0x02 && events[2].data[CMD_POS] == 0xCF);
+    ASSERT(memcmp(events[2].data + HEADER_SIZE, data, CWAKE_TRACE_BYTES - HEADER_SIZE) == 0);
+    ASSERT(events[3].stage == CWAKE_TRACE_ERROR && events[3].code == CWAKE_ERROR_CRC);
+
+    //=== dump of latest events only ===
+    ASSERT(cwake_trace_dump(&platform, events, 2) == 2);
+    ASSERT(events[0].seq == 3 && events[1].seq == 4);
+
+    //=== ring keeps last CWAKE_TRACE_EVENTS events ===
+    for (uint32_t i = 0; i < CWAKE_TRACE_EVENTS + 3; i++) {
+        mock_tx_index = 0;
+        ASSERT(cwake_call(0x02, 0xCF, data, 1, &platform) == CWAKE_ERROR_NONE);
+    }
+    ASSERT(cwake_trace_dump(&platform, events, CWAKE_TRACE_EVENTS) == CWAKE_TRACE_EVENTS);
+    ASSERT(events[0].seq == 8);
+    ASSERT(events[CWAKE_TRACE_EVENTS - 1].seq == CWAKE_TRACE_EVENTS + 7);
+    ASSERT(events[CWAKE_TRACE_EVENTS - 1].stage == CWAKE_TRACE_TX);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+#endif
+
+static cwake_error hub_error = CWAKE_ERROR_NONE;
+
+static void hub_error_callback(cwake_platform* platform, cwake_error err) {
+    hub_error = err;
+}
+
+// poll hub until expected number of frames is handled or nothing happens
+static uint32_t hub_run(cwake_hub* hub, uint32_t expected) {
+    uint32_t total = 0;
+    for (int i = 0; i < 20 && total < expected; i++) {
+        uint32_t handled = 0;
+        if (cwake_hub_poll(hub, 50, &handled)) return total;
+        total += handled;
+    }
+    return total;
+}
+
+static void test_hub() {
+    log("TEST hub...");
+    total_counter+=1;
+
+    enum { PORTS = 4 };
+    int master[PORTS];
+    int slave[PORTS];
+    cwake_platform ports[PORTS];
+    cwake_hub_port storage[PORTS];
+    cwake_hub hub;
+
+    ASSERT(cwake_hub_init(&hub, storage, PORTS) == CWAKE_ERROR_NONE);
+    hub.error = hub_error_callback;
+    for (int i = 0; i < PORTS; i++) {
+        ASSERT(mock_pty_open(&master[i], &slave[i], 1) == 0);
+        ports[i] = mock_create_cwake_platform(0x01, 20);
+        ports[i].user = &slave[i];
+        ports[i].read = mock_fd_read;
+        ports[i].current_time_ms = mock_clock_ms;
+        cwake_init(&ports[i]);
+        ASSERT(cwake_hub_add(&hub, &ports[i], slave[i]) == CWAKE_ERROR_NONE);
+    }
+    ASSERT(cwake_hub_add(&hub, &ports[0], slave[0]) == CWAKE_ERROR_OVERFLOW);
+
+    //encode sample frame
+    cwake_platform encoder = mock_create_cwake_platform(0x01, 20);
+    cwake_init(&encoder);
+    mock_reset_buffers();
+    uint8_t data[] = {0x23, FESC, FEND, 0x3F};
+    cwake_call(0x01, 0x42, data, sizeof(data), &encoder);
+    uint8_t frame[16];
+    uint32_t frame_size = mock_tx_index;
+    memcpy(frame, mock_tx_buffer, frame_size);
+
+    //only ports with data are handled, two frames of one read at once
+    handle_counter = 0;
+    mock_fd_write(&master[0], frame, frame_size);
+    mock_fd_write(&master[2], frame, frame_size);
+    mock_fd_write(&master[2], frame, frame_size);
+    ASSERT(hub_run(&hub, 3) == 3);
+    ASSERT(handle_counter == 3);
+    ASSERT(mock_called_cmd == 0x42);
+    ASSERT(hub.heap_size == 0);
+
+    //partial frame schedules receive timeout
+    hub_error = CWAKE_ERROR_NONE;
+    mock_fd_write(&master[1], frame, 3);
+    ASSERT(hub_run(&hub, 1) == 0);
+    ASSERT(hub_error == CWAKE_ERROR_TIMEOUT);
+    ASSERT(hub.heap_size == 0);
+
+    //port is served after timeout and after removal of another port
+    ASSERT(cwake_hub_remove(&hub, &ports[0]) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_hub_remove(&hub, &ports[0]) == CWAKE_ERROR_INVALID_DATA);
+    ASSERT(hub.ports_count == PORTS - 1);
+    handle_counter = 0;
+    mock_fd_write(&master[0], frame, frame_size);
+    mock_fd_write(&master[1], frame, frame_size);
+    mock_fd_write(&master[3], frame, frame_size);
+    ASSERT(hub_run(&hub, 2) == 2);
+    ASSERT(handle_counter == 2);
+
+    //wait ends at deadline of async call made outside of hub
+    struct async_result result = {CWAKE_ERROR_NONE, 0, 0, {0}};
+    ASSERT(cwake_call_async(0x02, 0x43, data, 1, async_done, &result, 30, &ports[1]) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_hub_watch(&hub, &ports[1]) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_hub_watch(&hub, &encoder) == CWAKE_ERROR_INVALID_DATA);
+    uint32_t start = mock_clock_ms(NULL);
+    ASSERT(cwake_hub_poll(&hub, 1000, NULL) == CWAKE_ERROR_NONE);
+    ASSERT(mock_clock_ms(NULL) - start < 500);
+    ASSERT(result.count == 1 && result.err == CWAKE_ERROR_TIMEOUT);
+    ASSERT(hub.heap_size == 0);
+
+    cwake_hub_close(&hub);
+    for (int i = 0; i < PORTS; i++) mock_pty_close(master[i], slave[i]);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+static uint32_t pool_gate = 0;
+
+static int32_t pool_work(void* ctx, uint8_t cmd, uint8_t* data, uint16_t size,
+                         uint8_t** rdata, uint16_t* rsize) {
+    //slow command waits until test releases it
+    if (cmd == 0x30) {
+        while (!__atomic_load_n(&pool_gate, __ATOMIC_ACQUIRE)) sched_yield();
+    }
+    //response too large for a classic frame (or for the job)
+    if (cmd == 0x33) {
+        static uint8_t large[252];
+        *rdata = large;
+        *rsize = sizeof(large);
+        return 0;
+    }
+    (*rdata)[0] = cmd;
+    *rsize = 1;
+    return 0;
+}
+
+// commands of response frames written so far
+static uint32_t pool_responses(uint8_t* cmds) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i + 2 < mock_tx_index; i++) {
+        if (mock_tx_buffer[i] == FEND) cmds[count++] = mock_tx_buffer[i + 2];
+    }
+    return count;
+}
+
+// poll pool until expected number of responses or wait_ms
+static uint32_t pool_run(cwake_pool* pool, uint32_t expected, uint8_t* cmds, uint32_t wait_ms) {
+    uint32_t start = mock_clock_ms(NULL);
+    uint32_t count = 0;
+    while (mock_clock_ms(NULL) - start < wait_ms) {
+        cwake_pool_poll(pool, NULL);
+        count = pool_responses(cmds);
+        if (count >= expected) break;
+        sched_yield();
+    }
+    return count;
+}
+
+static void test_worker_pool() {
+    log("TEST worker pool...");
+    total_counter+=1;
+
+    static cwake_pool pool;
+    cwake_platform platform = mock_create_cwake_platform(0x01, 1000);
+    platform.write = mock_write_append;
+    platform.current_time_ms = mock_clock_ms;
+    cwake_init(&platform);
+    ASSERT(cwake_pool_start(&pool, &platform, 2) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_pool_register(&pool, 0x30, pool_work, NULL, 1) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_pool_register(&pool, 0x31, pool_work, NULL, 0) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_pool_register(&pool, 0x32, pool_work, NULL, 1) == CWAKE_ERROR_NONE);
+
+    //slow ordered, fast unordered, fast ordered and inline commands
+    mock_reset_buffers();
+    uint8_t data[] = {0x11, FEND};
+    uint8_t cmds[8];
+    ASSERT(cwake_call(0x01, 0x30, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x01, 0x31, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x01, 0x32, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x01, 0x20, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+    memset(mock_tx_buffer, 0, mock_rx_index);
+
+    //unordered response passes slow command, ordered one waits for it
+    __atomic_store_n(&pool_gate, 0, __ATOMIC_RELEASE);
+    handle_counter = 0;
+    ASSERT(pool_run(&pool, 1, cmds, 1000) == 1);
+    ASSERT(cmds[0] == 0x31);
+    ASSERT(handle_counter == 1);
+    ASSERT(pool_run(&pool, 2, cmds, 50) == 1);
+    ASSERT(cwake_pool_busy(&pool) == 3);
+
+    __atomic_store_n(&pool_gate, 1, __ATOMIC_RELEASE);
+    ASSERT(pool_run(&pool, 3, cmds, 1000) == 3);
+    ASSERT(cmds[1] == 0x30 && cmds[2] == 0x32);
+    ASSERT(cwake_pool_busy(&pool) == 0);
+    ASSERT(pool.dropped == 0);
+
+    //response that cannot be sent is dropped, later ones are not blocked
+    ASSERT(cwake_pool_register(&pool, 0x33, pool_work, NULL, 1) == CWAKE_ERROR_NONE);
+    mock_reset_buffers();
+    ASSERT(cwake_call(0x01, 0x33, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    ASSERT(cwake_call(0x01, 0x32, data, sizeof(data), &platform) == CWAKE_ERROR_NONE);
+    memcpy(mock_rx_buffer, mock_tx_buffer, mock_tx_index);
+    mock_rx_index = mock_tx_index;
+    mock_tx_index = 0;
+    memset(mock_tx_buffer, 0, mock_rx_index);
+    ASSERT(pool_run(&pool, 1, cmds, 1000) == 1);
+    ASSERT(cmds[0] == 0x32);
+    ASSERT(cwake_pool_busy(&pool) == 0);
+    ASSERT(pool.dropped == (CWAKE_DATA_MAX >= 252));
+
+    //handled inline again after stop
+    cwake_pool_stop(&pool);
+#if CWAKE_HANDLERS
+    ASSERT(platform.service.handler_index[0x30] == 0);
+#endif
+    ASSERT(cwake_pool_start(&pool, &platform, 1) == CWAKE_ERROR_NONE);
+    cwake_pool_stop(&pool);
+    platform.full_duplex = 1;
+    ASSERT(cwake_pool_start(&pool, &platform, 1) == CWAKE_ERROR_INVALID_DATA);
+
+    pass_counter+=1;
+    log("PASSED");
+}
+
+int cwake_lib_test(void) {
     log("=== Starting CWAKE library tests ===");
 
     test_packet_formation();
+    test_fused_encoding();
+    test_crc8();
+    test_scatter_gather();
+    test_batch_transmit();
+#if CWAKE_TX_QUEUE_SIZE
+    test_tx_queue();
+#endif
+    test_stuffing_kernels();
+    test_destuffing_kernels();
+    test_frame_scanning();
+    test_batch_reception();
+    test_resync();
+    test_ring_reception();
     test_packet_reception();
     test_handler_return();
+#if CWAKE_HANDLERS >= 2
+    test_handler_dispatch();
+#endif
+#if CWAKE_FULL_DUPLEX
+    test_full_duplex();
+#endif
+    test_async_call();
+    test_extended_frames();
+    test_bulk_transfer();
     test_timeout();
+    test_stats();
+#ifdef CWAKE_TRACE
+    test_trace();
+#endif
+    test_hub();
+    test_worker_pool();
 
     log("=== All CWAKE library tests complete ===");
     log("PASSED %d / %d", pass_counter, total_counter);
+    return total_counter - pass_counter;
 }
@@ -8,6 +8,7 @@
 #ifndef TESTS_H
 #define TESTS_H
 
-void cwake_lib_test(void);
+// run all tests, return number of failed ones
+int cwake_lib_test(void);
 
 #endif